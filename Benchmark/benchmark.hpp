@@ -0,0 +1,131 @@
+#pragma once
+
+#include "chaoscv.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		class Result
+		{
+		public:
+			std::string name;
+			double ns = 0; // ÿεƽ
+			size_t bytes = 0; // ÿδֽ
+			double flops = 0; // ÿεĸ
+			double allocs = -1; // ÿͨMatAllocatorڴĴ-1ʾûͳ
+		};
+
+		// ен˳
+		inline std::vector<Result>& Results()
+		{
+			static std::vector<Result> results;
+			return results;
+		}
+
+		// дݣֻͳֽڲʽ־Ŀ
+		class NullBuffer : public std::streambuf
+		{
+		public:
+			size_t bytes = 0;
+
+		protected:
+			int_type overflow(int_type ch) override
+			{
+				if (ch != traits_type::eof()) bytes++;
+				return ch;
+			}
+			std::streamsize xsputn(const char*, std::streamsize count) override
+			{
+				bytes += (size_t)count;
+				return count;
+			}
+		};
+
+		// ظִfuncʱΪmin_time룬ÿεƽ
+		inline double Measure(const std::function<void()>& func, double min_time = 0.5)
+		{
+			func(); // Ԥȣ˳ڴ
+
+			size_t iters = 1;
+			while (true)
+			{
+				auto start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < iters; i++) func();
+				double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				if (elapsed >= min_time) return elapsed * 1e9 / iters;
+				iters = elapsed <= 0 ? iters * 10 : std::max(iters + 1, (size_t)(iters * min_time * 1.2 / elapsed));
+			}
+		}
+
+		// ִitersfuncƽÿĬϷڴĴ
+		inline double CountAllocations(const std::function<void()>& func, size_t iters = 16)
+		{
+			MatAllocator* allocator = MatAllocator::GetDefault();
+			size_t begin = allocator->Stats().allocations;
+			for (size_t i = 0; i < iters; i++) func();
+			return (double)(allocator->Stats().allocations - begin) / iters;
+		}
+
+		// bytesΪÿδֽΪ0ʱallocsС0ʱ
+		inline void Report(const std::string& name, double ns, size_t bytes = 0, double allocs = -1)
+		{
+			std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << ns << " ns/op";
+			if (bytes > 0) std::cout << std::setw(10) << std::setprecision(2) << bytes / ns << " GB/s";
+			if (allocs >= 0) std::cout << std::setw(10) << std::setprecision(2) << allocs << " allocs/op";
+			std::cout << std::endl;
+
+			Result result;
+			result.name = name;
+			result.ns = ns;
+			result.bytes = bytes;
+			result.allocs = allocs;
+			Results().push_back(result);
+		}
+
+		// flopsΪÿεĸ
+		inline void ReportFlops(const std::string& name, double ns, double flops)
+		{
+			std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << ns << " ns/op";
+			std::cout << std::setw(10) << std::setprecision(2) << flops / ns << " GFLOPS" << std::endl;
+
+			Result result;
+			result.name = name;
+			result.ns = ns;
+			result.flops = flops;
+			Results().push_back(result);
+		}
+
+		// ͬʱͳڴ
+		inline void Run(const std::string& name, const std::function<void()>& func, size_t bytes = 0, double min_time = 0.5)
+		{
+			double ns = Measure(func, min_time);
+			Report(name, ns, bytes, CountAllocations(func));
+		}
+
+		// ΪJSONΪ֮ԱȵĻ׼
+		void SaveResults(const std::string& file, const std::vector<Result>& results);
+		std::vector<Result> LoadResults(const std::string& file);
+		// ͻ׼Աȣʱӳthreshold߷ӵΪ˻˻ĸ
+		size_t CompareResults(const std::vector<Result>& baseline, const std::vector<Result>& results, double threshold);
+
+		void BenchmarkMat();
+		void BenchmarkCopy();
+		void BenchmarkTraverse();
+		void BenchmarkFormat();
+		void BenchmarkLog();
+		void BenchmarkFlags();
+		void BenchmarkGemm();
+
+	} // namespace benchmark
+
+} // namespace chaos
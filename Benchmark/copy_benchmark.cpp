@@ -0,0 +1,55 @@
+#include "benchmark.hpp"
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		// ԭClonesliceпÿж¼ԪشСΪԱȵĻ׼
+		static Mat LegacyClone(const Mat& src)
+		{
+			Mat mtx(src.size, src.depth);
+
+			auto dst = mtx.data;
+			for (size_t slice = 0; slice < mtx.step.slice_cnt; slice++)
+			{
+				auto ptr = src.data_start + ((slice / src.size[1]) * src.step[0] + (slice % src.size[1]) * src.step[1]) * (int)std::powf(2, src.depth / 2);
+				for (size_t row = 0; row < mtx.size[2]; row++)
+				{
+					auto data = ptr + row * src.step[2] * (int)std::powf(2, src.depth / 2);
+
+					memcpy_s(dst, mtx.size[3] * std::powf(2, src.depth / 2), data, mtx.size[3] * std::powf(2, src.depth / 2));
+
+					dst += mtx.size[3] * (int)std::powf(2, src.depth / 2);
+				}
+			}
+
+			return mtx;
+		}
+
+		static void BenchmarkCase(const std::string& name, const Mat& src)
+		{
+			size_t bytes = src.size[0] * src.size[1] * src.size[2] * src.size[3] * ElemSize(src.depth);
+
+			Run(name + " legacy clone", [&]() { Mat dst = LegacyClone(src); }, bytes);
+			Run(name + " clone", [&]() { Mat dst = src.Clone(); }, bytes);
+
+			Mat dst;
+			Run(name + " copy to", [&]() { src.CopyTo(dst); }, bytes);
+		}
+
+		void BenchmarkCopy()
+		{
+			std::cout << "---- Clone / CopyTo ----" << std::endl;
+
+			BenchmarkCase("64x64 32F", Mat(MatSize(1, 1, 64, 64), DEPTH_32F));
+			BenchmarkCase("8x3x224x224 32F", Mat(MatSize(8, 3, 224, 224), DEPTH_32F));
+			BenchmarkCase("3x1080x1920 8U", Mat(MatSize(1, 3, 1080, 1920), DEPTH_8U));
+			BenchmarkCase("64x256x256 32F", Mat(MatSize(1, 64, 256, 256), DEPTH_32F));
+
+			Mat image(MatSize(1, 3, 1080, 1920), DEPTH_8U);
+			BenchmarkCase("3x1080x1920 8U roi 1600x900", image(Rect(100, 100, 1600, 900)));
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
@@ -0,0 +1,30 @@
+#include "benchmark.hpp"
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		// ֻڲԲ
+		DEFINE_INT(benchmark_parse_int, 0, "used by the flag parsing benchmark.");
+		DEFINE_FLOAT(benchmark_parse_float, 0, "used by the flag parsing benchmark.");
+		DEFINE_BOOL(benchmark_parse_bool, false, "used by the flag parsing benchmark.");
+		DEFINE_STRING(benchmark_parse_string, "", "used by the flag parsing benchmark.");
+
+		void BenchmarkFlags()
+		{
+			std::cout << "---- Flags ----" << std::endl;
+
+			// ȫǲʣargv
+			const char* args[] = { "--benchmark_parse_int=42", "-benchmark_parse_float", "1.5",
+				"--benchmark_parse_bool", "--benchmark_parse_string=benchmark" };
+			Run("parse 4 flags", [&]() {
+				int argc = (int)(sizeof(args) / sizeof(args[0]));
+				char** argv = (char**)args;
+				ParseCommondLineFlags(&argc, &argv, false);
+			});
+			CHECK(42 == flag_benchmark_parse_int && flag_benchmark_parse_bool && "benchmark" == flag_benchmark_parse_string);
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
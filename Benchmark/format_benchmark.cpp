@@ -0,0 +1,55 @@
+#include "benchmark.hpp"
+
+#include <random>
+#include <sstream>
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		template<class Type>
+		static void Fill(Mat& mtx)
+		{
+			std::mt19937 rng(0);
+			std::uniform_real_distribution<double> dist(0, 100);
+			MatRowIterator it({ &mtx });
+			for (size_t row = 0; row < it.rows; row++)
+			{
+				Type* ptr = (Type*)it.Ptr(0, row);
+				for (size_t i = 0; i < it.length; i++) ptr[i] = (Type)dist(rng);
+			}
+		}
+
+		static void FormatCase(const std::string& name, const Mat& mtx)
+		{
+			static const std::pair<MatFormatType, const char*> formats[] = {
+				{ MFT_DEFAULT, "default" }, { MFT_MATLAB, "matlab" }, { MFT_PYTHON, "python" }, { MFT_CSV, "csv" } };
+
+			for (auto& format : formats)
+			{
+				auto formatter = MatFormatter::Get(format.first);
+				NullBuffer buffer;
+				std::ostream stream(&buffer);
+				stream << formatter->Format(mtx);
+
+				// ıֽ
+				Run(name + " " + format.second, [&]() { stream << formatter->Format(mtx); }, buffer.bytes, 0.2);
+			}
+		}
+
+		void BenchmarkFormat()
+		{
+			std::cout << "---- Format ----" << std::endl;
+
+			Mat mat32f(MatSize(1, 3, 256, 256), DEPTH_32F);
+			Fill<float>(mat32f);
+			FormatCase("3x256x256 32F", mat32f);
+
+			Mat mat8u(MatSize(1, 3, 256, 256), DEPTH_8U);
+			Fill<uchar>(mat8u);
+			FormatCase("3x256x256 8U", mat8u);
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
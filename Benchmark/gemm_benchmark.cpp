@@ -0,0 +1,81 @@
+#include "benchmark.hpp"
+
+#include <random>
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		// ֱӵѭΪԱȵĻ׼
+		template<class Type>
+		static void NaiveGemm(const Mat& A, const Mat& B, Mat& C)
+		{
+			size_t M = A.size[2], K = A.size[3], N = B.size[3];
+			const Type* a = (const Type*)A.data;
+			const Type* b = (const Type*)B.data;
+			Type* c = (Type*)C.data;
+			for (size_t i = 0; i < M; i++)
+			{
+				for (size_t j = 0; j < N; j++)
+				{
+					Type acc = 0;
+					for (size_t k = 0; k < K; k++) acc += a[i * K + k] * b[k * N + j];
+					c[i * N + j] = acc;
+				}
+			}
+		}
+
+		template<class Type>
+		static void Fill(Mat& mtx)
+		{
+			std::mt19937 rng(0);
+			std::uniform_real_distribution<Type> dist(-1, 1);
+			Type* data = (Type*)mtx.data;
+			for (size_t i = 0; i < mtx.size[2] * mtx.size[3]; i++) data[i] = dist(rng);
+		}
+
+		template<class Type>
+		static void BenchmarkCase(const std::string& type, MatDepth depth, size_t n)
+		{
+			Mat A(MatSize(1, 1, n, n), depth), B(MatSize(1, 1, n, n), depth), C;
+			Fill<Type>(A);
+			Fill<Type>(B);
+			double flops = 2.0 * n * n * n;
+			std::string name = std::to_string(n) + "x" + std::to_string(n) + " " + type;
+
+			// ʵ̫ߴֻһ
+			if (n <= 512)
+			{
+				Mat D(MatSize(1, 1, n, n), depth);
+				ReportFlops(name + " naive", Measure([&]() { NaiveGemm<Type>(A, B, D); }, n <= 256 ? 0.5 : 0), flops);
+			}
+			ReportFlops(name + " gemm", Measure([&]() { Gemm(A, B, C); }, n <= 1024 ? 0.5 : 0), flops);
+		}
+
+		// int8Ĳȡ[-127, 127]һ
+		static void BenchmarkInt8(size_t n)
+		{
+			Mat A(MatSize(1, 1, n, n), DEPTH_8S), B(MatSize(1, 1, n, n), DEPTH_8S), C;
+			std::mt19937 rng(0);
+			std::uniform_int_distribution<int> dist(-127, 127);
+			for (size_t i = 0; i < n * n; i++)
+			{
+				((char*)A.data)[i] = (char)dist(rng);
+				((char*)B.data)[i] = (char)dist(rng);
+			}
+			std::string name = std::to_string(n) + "x" + std::to_string(n) + " 8S";
+			ReportFlops(name + " gemm", Measure([&]() { GemmInt8(A, B, C); }, n <= 1024 ? 0.5 : 0), 2.0 * n * n * n);
+		}
+
+		void BenchmarkGemm()
+		{
+			std::cout << "---- Gemm (" << GetNumThreads() << " threads) ----" << std::endl;
+
+			for (size_t n = 64; n <= 4096; n *= 2) BenchmarkCase<float>("32F", DEPTH_32F, n);
+			for (size_t n = 64; n <= 4096; n *= 2) BenchmarkCase<double>("64F", DEPTH_64F, n);
+			for (size_t n = 64; n <= 4096; n *= 2) BenchmarkInt8(n);
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
@@ -0,0 +1,43 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		void BenchmarkLog()
+		{
+			std::cout << "---- Log ----" << std::endl;
+
+			// ־std::coutʱֻʽ·
+			NullBuffer buffer;
+			std::streambuf* origin = std::cout.rdbuf(&buffer);
+
+			int frame = 0;
+			double cost = 1.25;
+			std::vector<std::pair<std::string, std::function<void()>>> cases = {
+				{ "LOG(INFO) text", [&]() { LOG(INFO) << "benchmark log message"; } },
+				{ "LOG(INFO) int + double", [&]() { LOG(INFO) << "frame " << frame++ << " cost " << cost << " ms"; } },
+				{ "VLOG(1) filtered", [&]() { VLOG(1) << "frame " << frame++ << " cost " << cost << " ms"; } },
+				{ "LOG_EVERY_N(INFO, 1000)", [&]() { LOG_EVERY_N(INFO, 1000) << "frame " << frame++; } },
+				{ "BLOG(INFO) text fallback", [&]() { BLOG(INFO, "frame {} cost {} ms", frame++, cost); } },
+			};
+
+			std::vector<std::pair<std::string, double>> results;
+			for (auto& item : cases) results.emplace_back(item.first, Measure(item.second, 0.2));
+
+			// ־дʱļɾ
+			std::string file = "benchmark.blog";
+			BinaryLog::Open(file);
+			results.emplace_back("BLOG(INFO) binary", Measure([&]() { BLOG(INFO, "frame {} cost {} ms", frame++, cost); }, 0.2));
+			BinaryLog::Close();
+			std::remove(file.c_str());
+
+			std::cout.rdbuf(origin);
+			for (auto& item : results) Report(item.first, item.second);
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
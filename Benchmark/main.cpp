@@ -0,0 +1,40 @@
+#include "benchmark.hpp"
+
+namespace chaos
+{
+	DEFINE_STRING(benchmark_filter, "", "only run the suites whose name contains this string.");
+	DEFINE_STRING(benchmark_out, "", "save the results as JSON, which can be used as a baseline later.");
+	DEFINE_STRING(benchmark_baseline, "", "compare the results with this JSON file and report regressions.");
+	DEFINE_FLOAT(benchmark_threshold, 0.1f, "a case is a regression if it is slower than the baseline by this ratio.");
+} // namespace chaos
+
+// Benchmark [--benchmark_filter=mat] [--benchmark_out=baseline.json] [--benchmark_baseline=baseline.json]
+// ˻ʱ1
+int main(int argc, char** argv)
+{
+	chaos::ParseCommondLineFlags(&argc, &argv);
+
+	std::vector<std::pair<std::string, void(*)()>> suites = {
+		{ "mat", chaos::benchmark::BenchmarkMat },
+		{ "copy", chaos::benchmark::BenchmarkCopy },
+		{ "traverse", chaos::benchmark::BenchmarkTraverse },
+		{ "format", chaos::benchmark::BenchmarkFormat },
+		{ "log", chaos::benchmark::BenchmarkLog },
+		{ "flags", chaos::benchmark::BenchmarkFlags },
+		{ "gemm", chaos::benchmark::BenchmarkGemm },
+	};
+	for (auto& suite : suites)
+	{
+		if (suite.first.find(chaos::flag_benchmark_filter) != std::string::npos) suite.second();
+	}
+
+	auto& results = chaos::benchmark::Results();
+	if (!chaos::flag_benchmark_out.empty()) chaos::benchmark::SaveResults(chaos::flag_benchmark_out, results);
+	if (!chaos::flag_benchmark_baseline.empty())
+	{
+		auto baseline = chaos::benchmark::LoadResults(chaos::flag_benchmark_baseline);
+		if (chaos::benchmark::CompareResults(baseline, results, chaos::flag_benchmark_threshold) > 0) return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+
+#include <numeric>
+#include <sstream>
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		// ֹĽŻ
+		static volatile double sink;
+
+		void BenchmarkMat()
+		{
+			std::cout << "---- Mat construction / release ----" << std::endl;
+
+			Run("empty", []() { Mat mtx; });
+
+			for (auto size : { MatSize(1, 1, 64, 64), MatSize(8, 3, 224, 224), MatSize(1, 3, 1080, 1920) })
+			{
+				std::stringstream ss;
+				ss << size[0] << "x" << size[1] << "x" << size[2] << "x" << size[3] << " 32F";
+				size_t bytes = size[0] * size[1] * size[2] * size[3] * sizeof(float);
+
+				Run(ss.str() + " zero fill", [&]() { Mat mtx(size, DEPTH_32F); }, bytes);
+				Run(ss.str() + " uninitialized", [&]() { Mat mtx; mtx.Create(size, DEPTH_32F, false); });
+			}
+
+			Mat image(MatSize(1, 3, 1080, 1920), DEPTH_8U);
+			Run("copy (shared data)", [&]() { Mat mtx(image); });
+			Run("move", [&]() { Mat mtx(image); Mat other(std::move(mtx)); });
+			Run("roi 1600x900", [&]() { Mat roi = image(Rect(100, 100, 1600, 900)); });
+
+			std::vector<float> data(64 * 64);
+			Run("wrap external data", [&]() { Mat mtx(MatSize(1, 1, 64, 64), DEPTH_32F, data.data()); });
+		}
+
+		static void TraverseCase(const std::string& name, const Mat& mtx)
+		{
+			const MatSize& size = mtx.size;
+			size_t bytes = size[0] * size[1] * size[2] * size[3] * sizeof(float);
+
+			Run(name + " GetPtr per element", [&]() {
+				double sum = 0;
+				for (int n = 0; n < (int)size[0]; n++)
+					for (int c = 0; c < (int)size[1]; c++)
+						for (int h = 0; h < (int)size[2]; h++)
+							for (int w = 0; w < (int)size[3]; w++) sum += *mtx.GetPtr<float>(n, c, h, w);
+				sink = sum;
+			}, bytes);
+
+			Run(name + " GetPtr per row", [&]() {
+				double sum = 0;
+				for (int n = 0; n < (int)size[0]; n++)
+					for (int c = 0; c < (int)size[1]; c++)
+						for (int h = 0; h < (int)size[2]; h++)
+						{
+							const float* row = mtx.GetPtr<float>(n, c, h, 0);
+							for (size_t w = 0; w < size[3]; w++) sum += row[w];
+						}
+				sink = sum;
+			}, bytes);
+
+			Run(name + " MatRowIterator", [&]() {
+				double sum = 0;
+				MatRowIterator it({ &mtx });
+				for (size_t row = 0; row < it.rows; row++)
+				{
+					const float* ptr = (const float*)it.Ptr(0, row);
+					for (size_t i = 0; i < it.length; i++) sum += ptr[i];
+				}
+				sink = sum;
+			}, bytes);
+		}
+
+		void BenchmarkTraverse()
+		{
+			std::cout << "---- Traverse ----" << std::endl;
+
+			Mat mtx(MatSize(1, 3, 512, 512), DEPTH_32F);
+			TraverseCase("3x512x512 32F", mtx);
+			TraverseCase("3x512x512 32F roi 400x400", mtx(Rect(50, 50, 400, 400)));
+
+			TMat<float> tmat({ 1, 3, 512, 512 });
+			size_t bytes = tmat.Total() * sizeof(float);
+			Run("3x512x512 32F TMat::ForEachSpan", [&]() {
+				double sum = 0;
+				tmat.ForEachSpan([&](TMatSpan<float> span) { for (float value : span) sum += value; });
+				sink = sum;
+			}, bytes);
+			Run("3x512x512 32F TMat iterator", [&]() { sink = std::accumulate(tmat.begin(), tmat.end(), 0.0); }, bytes);
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
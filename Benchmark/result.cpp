@@ -0,0 +1,172 @@
+#include "benchmark.hpp"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace chaos
+{
+	namespace benchmark
+	{
+		// ļʽ
+		// {
+		//   "benchmarks": [
+		//     {"name": "...", "ns": 1.0, "bytes": 0, "flops": 0, "allocs": -1},
+		//     ...
+		//   ]
+		// }
+
+		static std::string Escape(const std::string& str)
+		{
+			std::string escaped;
+			for (char ch : str)
+			{
+				if ('"' == ch || '\\' == ch) escaped += '\\';
+				escaped += ch;
+			}
+			return escaped;
+		}
+
+		void SaveResults(const std::string& file, const std::vector<Result>& results)
+		{
+			std::ofstream stream(file);
+			CHECK(stream.is_open()) << "Can not open " << file;
+
+			stream << "{\n  \"benchmarks\": [\n" << std::setprecision(17);
+			for (size_t i = 0; i < results.size(); i++)
+			{
+				const Result& result = results[i];
+				stream << "    {\"name\": \"" << Escape(result.name) << "\", \"ns\": " << result.ns
+					<< ", \"bytes\": " << result.bytes << ", \"flops\": " << result.flops
+					<< ", \"allocs\": " << result.allocs << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+			}
+			stream << "  ]\n}\n";
+			CHECK(stream) << "Failed to write " << file;
+		}
+
+		// ֻSaveResultsдĸʽbenchmarksеÿֵַֻ
+		class ResultParser
+		{
+		public:
+			ResultParser(const std::string& text) : text(text) {}
+
+			std::vector<Result> Parse()
+			{
+				std::vector<Result> results;
+				pos = text.find("\"benchmarks\"");
+				CHECK(std::string::npos != pos) << "Missing \"benchmarks\".";
+				pos = text.find('[', pos);
+				CHECK(std::string::npos != pos) << "Missing benchmark list.";
+				pos++;
+
+				while (Skip() != ']')
+				{
+					Expect('{');
+					Result result;
+					while (Skip() != '}')
+					{
+						std::string key = String();
+						Expect(':');
+						if ("name" == key) result.name = String();
+						else if ("ns" == key) result.ns = Number();
+						else if ("bytes" == key) result.bytes = (size_t)Number();
+						else if ("flops" == key) result.flops = Number();
+						else if ("allocs" == key) result.allocs = Number();
+						else LOG(FATAL) << "Unknown key " << key;
+						if (Skip() == ',') pos++;
+					}
+					pos++;
+					results.push_back(result);
+					if (Skip() == ',') pos++;
+				}
+				return results;
+			}
+
+		private:
+			// հףһַ
+			char Skip()
+			{
+				while (pos < text.size() && isspace((uchar)text[pos])) pos++;
+				CHECK_LT(pos, text.size()) << "Unexpected end of file.";
+				return text[pos];
+			}
+
+			void Expect(char ch)
+			{
+				CHECK_EQ(Skip(), ch) << "Expect '" << ch << "' at " << pos;
+				pos++;
+			}
+
+			std::string String()
+			{
+				Expect('"');
+				std::string str;
+				for (; pos < text.size() && text[pos] != '"'; pos++)
+				{
+					if ('\\' == text[pos]) pos++;
+					str += text[pos];
+				}
+				pos++;
+				return str;
+			}
+
+			double Number()
+			{
+				Skip();
+				size_t length = 0;
+				double value = std::stod(text.substr(pos, 32), &length);
+				pos += length;
+				return value;
+			}
+
+			const std::string& text;
+			size_t pos = 0;
+		};
+
+		std::vector<Result> LoadResults(const std::string& file)
+		{
+			std::ifstream stream(file);
+			CHECK(stream.is_open()) << "Can not open " << file;
+			std::stringstream text;
+			text << stream.rdbuf();
+			return ResultParser(text.str()).Parse();
+		}
+
+		size_t CompareResults(const std::vector<Result>& baseline, const std::vector<Result>& results, double threshold)
+		{
+			std::map<std::string, const Result*> base;
+			for (auto& result : baseline) base[result.name] = &result;
+
+			std::cout << "---- Compare with baseline (threshold " << threshold * 100 << "%) ----" << std::endl;
+			size_t regressions = 0;
+			for (auto& result : results)
+			{
+				auto it = base.find(result.name);
+				if (it == base.end())
+				{
+					std::cout << std::left << std::setw(48) << result.name << " (new)" << std::endl;
+					continue;
+				}
+
+				const Result& old = *it->second;
+				double change = old.ns > 0 ? result.ns / old.ns - 1 : 0;
+				bool slower = change > threshold;
+				bool more_allocs = old.allocs >= 0 && result.allocs > old.allocs;
+
+				std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed
+					<< std::setw(14) << std::setprecision(1) << old.ns << " ->" << std::setw(14) << result.ns << " ns/op"
+					<< std::setw(9) << std::showpos << std::setprecision(1) << change * 100 << "%" << std::noshowpos;
+				if (more_allocs) std::cout << "  allocs " << std::setprecision(2) << old.allocs << " -> " << result.allocs;
+				if (slower || more_allocs) std::cout << "  REGRESSION";
+				std::cout << std::endl;
+
+				if (slower || more_allocs) regressions++;
+			}
+
+			std::cout << regressions << " regression(s)." << std::endl;
+			return regressions;
+		}
+
+	} // namespace benchmark
+
+} // namespace chaos
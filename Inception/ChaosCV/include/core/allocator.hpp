@@ -0,0 +1,98 @@
+#pragma once
+
+#include "def.hpp"
+
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace chaos
+{
+	class MatAllocator;
+
+	// ݿͷݷͬһڴУ֮ǰ
+	// СΪ64ֽڣ֤ݵʼַҲ64ֽڶ
+	struct alignas(64) MatBlock
+	{
+		std::atomic<size_t> ref_cnt;
+		size_t capacity; // ʵֽ
+		MatAllocator* allocator; // ĸ䣬ͷʱ
+		int size_class; // ĳߴּ-1ʾڴ
+
+		// MatдMemoryTrackerʹ
+		size_t bytes; // Matʵʹõֽ
+		int depth;
+		bool tracked; // ǷMemoryTrackerϸ¼
+
+		uchar* Data() { return (uchar*)(this + 1); }
+		static MatBlock* FromData(uchar* data) { return (MatBlock*)data - 1; }
+	};
+
+	class AllocatorStats
+	{
+	public:
+		size_t allocations = 0; // Allocateĵô
+		size_t deallocations = 0;
+		size_t pool_hits = 0; // ֱӴӳȡõĴ
+		size_t pool_misses = 0; // ҪϵͳĴ
+		size_t bytes_in_use = 0; // ڱMatʹõֽ
+		size_t bytes_cached = 0; // лĿֽ
+
+		double HitRate() const { return allocations == 0 ? 0. : (double)pool_hits / allocations; }
+
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const AllocatorStats& stats);
+	};
+
+	// MatڴӿڣͨSetDefaultMat::allocator滻
+	class CHAOS_EXPORT MatAllocator
+	{
+	public:
+		virtual ~MatAllocator() {}
+
+		// صĿѾͷϢref_cntΪ164ֽڶ
+		virtual MatBlock* Allocate(size_t size, bool zero_fill) = 0;
+		virtual void Deallocate(MatBlock* block) = 0;
+
+		virtual AllocatorStats Stats() const { return AllocatorStats(); }
+
+		static MatAllocator* GetDefault();
+		static void SetDefault(MatAllocator* allocator);
+	};
+
+	// ߴּڴأÿ2ϸΪ4˷Ѳ25%
+	// ͬ״Matͷʱл÷ϵͳ
+	class CHAOS_EXPORT PoolAllocator : public MatAllocator
+	{
+	public:
+		// cache_limit: ໺Ŀֽ
+		PoolAllocator(size_t cache_limit = (size_t)1 << 30);
+		~PoolAllocator();
+
+		MatBlock* Allocate(size_t size, bool zero_fill) override;
+		void Deallocate(MatBlock* block) override;
+
+		AllocatorStats Stats() const override;
+
+		// ѻĿпȫϵͳ
+		void Trim();
+
+	private:
+		static int SizeClass(size_t size, size_t& capacity);
+
+		static constexpr int min_shift = 6; // 64B
+		static constexpr int max_shift = 30; // 1GBֱϵͳ
+
+		std::mutex mtx;
+		std::vector<std::vector<MatBlock*>> free_list;
+		size_t cache_limit;
+
+		std::atomic<size_t> allocations;
+		std::atomic<size_t> deallocations;
+		std::atomic<size_t> pool_hits;
+		std::atomic<size_t> pool_misses;
+		std::atomic<size_t> bytes_in_use;
+		std::atomic<size_t> bytes_cached;
+	};
+
+} // namespace chaos
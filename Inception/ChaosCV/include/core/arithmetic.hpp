@@ -0,0 +1,56 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace chaos
+{
+	// תΧʱȡֵ߽תʱͽȡż
+	template<class Type, class Src>
+	inline Type SaturateCast(Src value)
+	{
+		if constexpr (!std::is_integral<Type>::value)
+		{
+			return (Type)value;
+		}
+		else if constexpr (std::is_floating_point<Src>::value || IsHalf<Src>::value)
+		{
+			double v = std::rint((double)value);
+			if (v <= (double)std::numeric_limits<Type>::min()) return std::numeric_limits<Type>::min();
+			if (v >= (double)std::numeric_limits<Type>::max()) return std::numeric_limits<Type>::max();
+			return (Type)v;
+		}
+		else
+		{
+			long long v = (long long)value;
+			if (v < (long long)std::numeric_limits<Type>::min()) return std::numeric_limits<Type>::min();
+			if (v > (long long)std::numeric_limits<Type>::max()) return std::numeric_limits<Type>::max();
+			return (Type)v;
+		}
+	}
+
+	// Ԫ㣬src1src2״ȱͬdstᰴsrc1·
+	// dst״src1ͬʱֱд룬dstsrcһROI
+	// 8λ16λĽʹ32SļӼǻ
+	// 16F16BFתΪfloat㣬ͽȡż
+
+	// dst = src1 + src2
+	CHAOS_EXPORT void Add(const Mat& src1, const Mat& src2, Mat& dst);
+	// dst = src1 - src2
+	CHAOS_EXPORT void Subtract(const Mat& src1, const Mat& src2, Mat& dst);
+	// dst = src1 * src2 * scale
+	CHAOS_EXPORT void Multiply(const Mat& src1, const Mat& src2, Mat& dst, double scale = 1);
+	// dst = src1 * scale / src2ͳΪ0ʱΪ0
+	CHAOS_EXPORT void Divide(const Mat& src1, const Mat& src2, Mat& dst, double scale = 1);
+	// dst = src1 * alpha + src2
+	CHAOS_EXPORT void ScaleAdd(const Mat& src1, double alpha, const Mat& src2, Mat& dst);
+	CHAOS_EXPORT void Min(const Mat& src1, const Mat& src2, Mat& dst);
+	CHAOS_EXPORT void Max(const Mat& src1, const Mat& src2, Mat& dst);
+	// dst = |src|
+	CHAOS_EXPORT void Abs(const Mat& src, Mat& dst);
+
+} // namespace chaos
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "def.hpp"
+#include "log_message.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <iostream>
+
+namespace chaos
+{
+	// ־÷LOGƣڸʽ棬ʽе{}α滻
+	//   BLOG(INFO, "frame {} cost {} ms", frame_id, cost);
+	// õ㣨ļкšȼʽͲֻͣڵһִʱǼһ
+	// ֮ÿ¼ֻõšʱͲԭʼֽڣд뵱ǰ̵߳Ļκθʽ
+	// ıDecodeBinaryLogɣLogDecoder
+	// ûеBinaryLog::OpenʱֱӸʽıͨLogMessageFATALͬʱıж
+	// ֧boolcharconst char*std::string
+
+	class CHAOS_EXPORT BinaryLogSite
+	{
+	public:
+		BinaryLogSite(const char* file, int line, LogSeverity severity) : file(file), line(line), severity(severity) {}
+
+		const char* file;
+		int line;
+		LogSeverity severity;
+		std::atomic<uint32_t> id{ 0 }; // 0ʾûеǼ
+	};
+
+	class CHAOS_EXPORT BinaryLog
+	{
+	public:
+		// ֮BLOGдfileѾ򿪵ļȹر
+		static void Open(const std::string& file);
+		// д̻߳еļ¼رļ
+		static void Close();
+		static bool IsOpen();
+		// ̻߳еļ¼дļ
+		static void Flush();
+
+		template<class... Args>
+		static void Log(BinaryLogSite& site, const char* format, const Args&... args)
+		{
+			if (IsOpen())
+			{
+				uint32_t id = site.id.load(std::memory_order_relaxed);
+				if (0 == id)
+				{
+					char types[] = { ArgType<Args>::code..., '\0' };
+					id = RegisterSite(site, format, types);
+				}
+
+				size_t bytes = sizeof(uint32_t) + sizeof(int64_t) + (ArgBytes(args) + ... + 0);
+				char* ptr = Begin(bytes);
+				Put(ptr, id);
+				Put(ptr, (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::system_clock::now().time_since_epoch()).count());
+				(Put(ptr, args), ...);
+				End();
+
+				if (site.severity != FATAL) return;
+				Flush();
+			}
+
+			LogMessage message(site.file, site.line, site.severity);
+			Format(message.Stream(), format, args...);
+		}
+
+		// formatе{}滻ΪʱʹͬĹ
+		template<class... Args>
+		static void Format(std::ostream& stream, const char* format, const Args&... args)
+		{
+			(FormatNext(stream, format, args), ...);
+			stream << format;
+		}
+
+	private:
+		template<class Type, class Enable = void>
+		struct ArgType;
+
+		template<class Type>
+		static size_t ArgBytes(const Type&) { return sizeof(typename ArgType<Type>::Storage); }
+		static size_t ArgBytes(const char* str) { return sizeof(uint32_t) + strlen(str); }
+		static size_t ArgBytes(const std::string& str) { return sizeof(uint32_t) + str.size(); }
+
+		template<class Type>
+		static void Put(char*& ptr, const Type& value)
+		{
+			typename ArgType<Type>::Storage storage = (typename ArgType<Type>::Storage)value;
+			memcpy(ptr, &storage, sizeof(storage));
+			ptr += sizeof(storage);
+		}
+		static void Put(char*& ptr, const char* str) { PutString(ptr, str, strlen(str)); }
+		static void Put(char*& ptr, const std::string& str) { PutString(ptr, str.data(), str.size()); }
+		static void PutString(char*& ptr, const char* str, size_t length)
+		{
+			uint32_t len = (uint32_t)length;
+			memcpy(ptr, &len, sizeof(len));
+			memcpy(ptr + sizeof(len), str, length);
+			ptr += sizeof(len) + length;
+		}
+
+		// ʱ֤ͽĽһ£ucharΪ֣
+		template<class Type>
+		static void Print(std::ostream& stream, const Type& value) { stream << (typename ArgType<Type>::Storage)value; }
+		static void Print(std::ostream& stream, const char* str) { stream << str; }
+		static void Print(std::ostream& stream, const std::string& str) { stream << str; }
+
+		template<class Type>
+		static void FormatNext(std::ostream& stream, const char*& format, const Type& value)
+		{
+			const char* pos = strstr(format, "{}");
+			if (nullptr == pos)
+			{
+				// {}ʱں
+				stream << format << " ";
+				Print(stream, value);
+				format += strlen(format);
+				return;
+			}
+			stream.write(format, pos - format);
+			Print(stream, value);
+			format = pos + 2;
+		}
+
+		static uint32_t RegisterSite(BinaryLogSite& site, const char* format, const char* types);
+		// ڵǰ̵߳ĻԤbytesֽڣдEnd
+		static char* Begin(size_t bytes);
+		static void End();
+	};
+
+	// ͵ı룬¼аStorageĴС
+	template<class Type>
+	struct BinaryLog::ArgType<Type, typename std::enable_if<std::is_integral<Type>::value>::type>
+	{
+		static constexpr char code = std::is_same<Type, bool>::value ? 'b' :
+			std::is_same<Type, char>::value ? 'c' :
+			std::is_signed<Type>::value ? (sizeof(Type) <= 4 ? 'i' : 'I') : (sizeof(Type) <= 4 ? 'u' : 'U');
+		using Storage = typename std::conditional<code == 'b' || code == 'c', Type,
+			typename std::conditional<std::is_signed<Type>::value,
+			typename std::conditional<sizeof(Type) <= 4, int32_t, int64_t>::type,
+			typename std::conditional<sizeof(Type) <= 4, uint32_t, uint64_t>::type>::type>::type;
+	};
+	template<class Type>
+	struct BinaryLog::ArgType<Type, typename std::enable_if<std::is_floating_point<Type>::value>::type>
+	{
+		static constexpr char code = sizeof(Type) == 4 ? 'f' : 'd';
+		using Storage = typename std::conditional<sizeof(Type) == 4, float, double>::type;
+	};
+	template<class Type>
+	struct BinaryLog::ArgType<Type, typename std::enable_if<std::is_enum<Type>::value>::type>
+	{
+		static constexpr char code = 'i';
+		using Storage = int32_t;
+	};
+	template<class Type>
+	struct BinaryLog::ArgType<Type, typename std::enable_if<
+		std::is_same<typename std::decay<Type>::type, const char*>::value ||
+		std::is_same<typename std::decay<Type>::type, char*>::value ||
+		std::is_same<Type, std::string>::value>::type>
+	{
+		static constexpr char code = 's';
+	};
+
+	// BinaryLogдļתΪıʱÿһ
+	CHAOS_EXPORT void DecodeBinaryLog(std::istream& in, std::ostream& out);
+
+} // namespace chaos
+
+// ȼʱᱻֵ
+#define BLOG(severity, ...)									\
+  !chaos::LogMessage::IsOn(severity) ? (void)0 :			\
+  chaos::BinaryLog::Log([]() -> chaos::BinaryLogSite& {		\
+    static chaos::BinaryLogSite site(CHAOS_FILE_NAME, __LINE__, severity); return site; }(), __VA_ARGS__)
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+#include "quantize.hpp"
+
+namespace chaos
+{
+	// widthӦWheightӦH
+	class CHAOS_EXPORT ConvParam
+	{
+	public:
+		ConvParam(Size stride = Size(1, 1), Size pad = Size(0, 0), Size dilation = Size(1, 1), size_t groups = 1)
+			: stride(stride), pad(pad), dilation(dilation), groups(groups) {}
+
+		Size stride;
+		Size pad; // ͬ0
+		Size dilation;
+		size_t groups;
+	};
+
+	// άsrcΪN x Cin x H x WweightΪCout x (Cin / groups) x KH x KWֻ֧DEPTH_32F
+	// biasΪջCoutԪأdstN x Cout x Ho x Wo·
+	// ݲѡʵ֣1x1ֱGEMMdepthwiseֱӾͨ3x3Winograd F(2x2, 3x3)im2col + GEMM
+	CHAOS_EXPORT void Conv2D(const Mat& src, const Mat& weight, const Mat& bias, Mat& dst, const ConvParam& param = ConvParam());
+
+	// INT8״ҪͬConv2Dim2col + GemmInt8int32ۼӣΪDEPTH_32F
+	// srczero_pointλȡzero_point0weight߰ͨaxisΪ0Գ
+	// biasΪջCoutDEPTH_32FԪأ
+	CHAOS_EXPORT void Conv2DInt8(const QMat& src, const QMat& weight, const Mat& bias, Mat& dst, const ConvParam& param = ConvParam());
+	// ͬϣout_paramԱint8
+	CHAOS_EXPORT void Conv2DInt8(const QMat& src, const QMat& weight, const Mat& bias, QMat& dst, const QuantParam& out_param,
+		const ConvParam& param = ConvParam());
+
+} // namespace chaos
@@ -3,8 +3,22 @@
 #include "def.hpp"
 #include "flags.hpp"
 #include "log_message.hpp"
+#include "binary_log.hpp"
+#include "cpu.hpp"
+#include "parallel.hpp"
+#include "profiler.hpp"
 
+#include "allocator.hpp"
+#include "half.hpp"
 #include "mat.hpp"
+#include "memory_tracker.hpp"
+#include "arithmetic.hpp"
+#include "quantize.hpp"
+#include "gemm.hpp"
+#include "convolution.hpp"
+#include "filter.hpp"
+#include "persistence.hpp"
+#include "mat_expr.hpp"
 
 namespace chaos
 {
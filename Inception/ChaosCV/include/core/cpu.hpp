@@ -0,0 +1,15 @@
+#pragma once
+
+#include "def.hpp"
+
+namespace chaos
+{
+	// CPUͲϵͳǷָָ֧
+	CHAOS_EXPORT bool CheckHardwareSupport(CpuFeature feature);
+
+	// ǰںʹõָȼĬΪӲֵ֧ߵȼ
+	CHAOS_EXPORT SimdLevel GetSimdLevel();
+	// ںʹõָӲֵ֧ĲֻᱻԣҪڲԺܶԱ
+	CHAOS_EXPORT void SetSimdLevel(SimdLevel level);
+
+} // namespace chaos
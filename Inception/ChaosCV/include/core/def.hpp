@@ -2,6 +2,10 @@
 
 #define CHAOS_EXPORT __declspec(dllexport)
 
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
 namespace chaos
 {
 	// ǰ
@@ -18,6 +22,7 @@ namespace chaos
 	template<class Type> class TMat;
 	template<class Type> class TMatIterator;
 	template<class Type> class TMatInitializer;
+	template<class Derived> class MatExpr;
 
 	using uchar = unsigned char;
 	using ushort = unsigned short;
@@ -42,10 +47,73 @@ namespace chaos
 		DEPTH_32S, // int
 		DEPTH_32F, // float 4
 		DEPTH_64F, // double 8
+		DEPTH_16F, // float16 2
+		DEPTH_16BF, // bfloat16 2
 
 		DEPTH_UNKNOW = -1,
 	};
 
+	// ȵԪԣMatDepth˳
+	class DepthInfo
+	{
+	public:
+		const char* name;
+		size_t size; // ÿԪصֽ
+		size_t alignment;
+		bool is_signed;
+		bool is_float;
+		double min; // ԱʾСֵֵΪֵ
+		double max;
+	};
+
+	inline constexpr DepthInfo depth_infos[] = {
+		{ "8U", 1, 1, false, false, 0, 255 },
+		{ "8S", 1, 1, true, false, -128, 127 },
+		{ "16U", 2, 2, false, false, 0, 65535 },
+		{ "16S", 2, 2, true, false, -32768, 32767 },
+		{ "32S", 4, 4, true, false, -2147483648.0, 2147483647.0 },
+		{ "32F", 4, 4, true, true, -3.402823466e+38, 3.402823466e+38 },
+		{ "64F", 8, 8, true, true, -1.7976931348623158e+308, 1.7976931348623158e+308 },
+		{ "16F", 2, 2, true, true, -65504, 65504 },
+		{ "16BF", 2, 2, true, true, -3.3895313892515355e+38, 3.3895313892515355e+38 },
+	};
+
+	constexpr int depth_type_count = (int)(sizeof(depth_infos) / sizeof(depth_infos[0]));
+
+	constexpr bool IsValidDepth(MatDepth depth)
+	{
+		return 0 <= depth && depth < depth_type_count;
+	}
+
+	// depthЧ
+	constexpr const DepthInfo& GetDepthInfo(MatDepth depth)
+	{
+		return depth_infos[depth];
+	}
+
+	// ÿԪصֽDEPTH_UNKNOWΪ0
+	constexpr size_t ElemSize(MatDepth depth)
+	{
+		return IsValidDepth(depth) ? depth_infos[depth].size : 0;
+	}
+
+	// ڴезʽMat±ʼNCHW
+	enum MatLayout
+	{
+		LAYOUT_NCHW,
+		LAYOUT_NHWC, // ͨOpenCV/ͼһ
+	};
+
+	// ˲ʱ߽ȡֵabcdefghΪ
+	enum BorderType
+	{
+		BORDER_CONSTANT, // 000000|abcdefgh|000000
+		BORDER_REPLICATE, // aaaaaa|abcdefgh|hhhhhh
+		BORDER_REFLECT, // fedcba|abcdefgh|hgfedc
+		BORDER_REFLECT_101, // gfedcb|abcdefgh|gfedcb
+		BORDER_WRAP, // cdefgh|abcdefgh|abcdef
+	};
+
 	enum MatFormatType
 	{
 		MFT_DEFAULT,
@@ -53,15 +121,86 @@ namespace chaos
 		MFT_PYTHON,
 		MFT_CSV,
 	};
+
+	enum CpuFeature
+	{
+		CPU_SSE2,
+		CPU_SSE41,
+		CPU_AVX,
+		CPU_AVX2,
+		CPU_FMA3,
+		CPU_AVX512F,
+		CPU_AVX512BW,
+		CPU_AVX512DQ,
+		CPU_F16C,
+		CPU_AVX512VNNI,
+
+		CPU_FEATURE_COUNT,
+	};
+
+	// ںʵʹõָȼ
+	enum SimdLevel
+	{
+		SIMD_NONE, // 
+		SIMD_SSE2,
+		SIMD_AVX2, // AVX2 + FMA3 + F16C
+		SIMD_AVX512, // AVX512F + AVX512BW
+	};
 	
 
+	// ·ļֵʼλãڱȥ__FILE__еĿ¼
+	constexpr size_t BasenameOffset(const char* path)
+	{
+		size_t offset = 0;
+		for (size_t i = 0; path[i] != '\0'; i++)
+		{
+			if (path[i] == '\\' || path[i] == '/') offset = i + 1;
+		}
+		return offset;
+	}
+
 } // namespace chaos
 
-#define LOG(severity) chaos::LogMessage(					\
-  __FILE__, __LINE__, severity).Stream()
+#define CHAOS_FILE_NAME (__FILE__ +							\
+  std::integral_constant<size_t, chaos::BasenameOffset(__FILE__)>::value)
+
+#define LOG_STREAM(severity) chaos::LogMessage(				\
+  CHAOS_FILE_NAME, __LINE__, severity).Stream()
+
+// ߵȼʱLogMessageṹ죬<<ҲıʽҲֵ
+#define LOG_IF(severity, condition)							\
+  !(chaos::LogMessage::IsOn(severity) && (condition)) ? (void)0 :	\
+  chaos::LogMessageVoidify() & LOG_STREAM(severity)
+
+#define LOG(severity) LOG_IF(severity, true)
+
+// ϸ־ֻ--v >= verbose_levelʱȼΪINFO
+#define VLOG(verbose_level)									\
+  LOG_IF(chaos::INFO, chaos::LogMessage::VerboseOn(verbose_level))
+
+// ÿõԼļlambdaеstaticÿκչʱǶ
+#define CHAOS_SITE_COUNTER()								\
+  ([]() -> std::atomic<size_t>& { static std::atomic<size_t> counter(0); return counter; }())
+
+// 1n+12n+1...ִʱʱֻһrelaxedԭӼӣn <= 0ʱ
+#define LOG_EVERY_N(severity, n)							\
+  LOG_IF(severity, chaos::LogMessage::EveryN(CHAOS_SITE_COUNTER(), n))
+
+// ֻǰnΣֻ֮һμ
+#define LOG_FIRST_N(severity, n)							\
+  LOG_IF(severity, chaos::LogMessage::FirstN(CHAOS_SITE_COUNTER(), n))
+
+// ÿsecondsһΣ߳ͬʱʱֻһ
+#define LOG_EVERY_T(severity, seconds)						\
+  LOG_IF(severity, chaos::LogMessage::EveryT(				\
+    []() -> std::atomic<long long>& { static std::atomic<long long> next(0); return next; }(), seconds))
+
+// probabilityĸͳȵѭеݷֲ
+#define LOG_SAMPLED(severity, probability)					\
+  LOG_IF(severity, chaos::LogMessage::Sample(probability))
 
 #define CHECK(condition) condition ? (void)0 :				\
-  chaos::LogMessageVoidify() & LOG(chaos::FATAL) <<			\
+  chaos::LogMessageVoidify() & LOG_STREAM(chaos::FATAL) <<	\
   "Check failed: " #condition ". "
 
 #define CHECK_EQ(val1, val2) CHECK(val1 == val2)
@@ -71,6 +210,20 @@ namespace chaos
 #define CHECK_GE(val1, val2) CHECK(val1 >= val2)
 #define CHECK_GT(val1, val2) CHECK(val1 >  val2)
 
+// ֻDebug¼飬ReleaseᱻֵԪطȵ·
+#ifdef _DEBUG
+#define DCHECK(condition) CHECK(condition)
+#else
+#define DCHECK(condition) while (false) CHECK(condition)
+#endif
+
+#define DCHECK_EQ(val1, val2) DCHECK(val1 == val2)
+#define DCHECK_NE(val1, val2) DCHECK(val1 != val2)
+#define DCHECK_LE(val1, val2) DCHECK(val1 <= val2)
+#define DCHECK_LT(val1, val2) DCHECK(val1 <  val2)
+#define DCHECK_GE(val1, val2) DCHECK(val1 >= val2)
+#define DCHECK_GT(val1, val2) DCHECK(val1 >  val2)
+
 #define DO_NOT_IMIPLEMENT LOG(chaos::FATAL) << "DO NOT IMIPLEMENT";
 
 #define	DEFINE_FLAGS(type, name, value, help)				\
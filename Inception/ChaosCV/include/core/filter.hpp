@@ -0,0 +1,25 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+
+namespace chaos
+{
+	// ͼ˲ÿN x Cƽ浥srcROINHWCУROIı߽簴border
+	// dstsrc״·䣬depthΪDEPTH_UNKNOWʱsrcͬʹ
+	// һƽ棨H x Wê(KW / 2, KH / 2)
+
+	// Ķά
+	CHAOS_EXPORT void Filter2D(const Mat& src, Mat& dst, const Mat& kernel,
+		MatDepth depth = DEPTH_UNKNOW, BorderType border = BORDER_REFLECT_101);
+	// ɷľˣȰkernel_x˲ٰkernel_y˲
+	CHAOS_EXPORT void SepFilter2D(const Mat& src, Mat& dst, const Mat& kernel_x, const Mat& kernel_y,
+		MatDepth depth = DEPTH_UNKNOW, BorderType border = BORDER_REFLECT_101);
+	// ksizeΪ0ʱsigma㣬sigmaΪ0ʱksize㣬sigma_yΪ0ʱsigma_xͬ
+	CHAOS_EXPORT void GaussianBlur(const Mat& src, Mat& dst, Size ksize, double sigma_x, double sigma_y = 0,
+		BorderType border = BORDER_REFLECT_101);
+	// ͣnormalizeΪtrueʱƽÿصļ봰ڴС޹
+	CHAOS_EXPORT void BoxFilter(const Mat& src, Mat& dst, Size ksize, bool normalize = true,
+		MatDepth depth = DEPTH_UNKNOW, BorderType border = BORDER_REFLECT_101);
+
+} // namespace chaos
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+
+namespace chaos
+{
+	// C = alpha * op(A) * op(B) + beta * Cop(X)ΪXXת
+	// ÿH x WƽһAжƽʱƽ棨N * C㣬Bֻһƽʱι
+	// ABȱֻ֧ͬDEPTH_32FDEPTH_64FABROIͼ
+	// betaΪ0ʱC(A.N, A.C, M, N)·䣬ȡCԭеֵC״ȱȷ
+	CHAOS_EXPORT void Gemm(const Mat& A, const Mat& B, Mat& C, double alpha = 1, double beta = 0,
+		bool transA = false, bool transB = false);
+
+	// C = op(A) * op(B)ABΪDEPTH_8SCΪDEPTH_32Sint32ۼӣƽͼĹͬGemm
+	// ֧AVX512-VNNIʱvpdpbusdpmaddubsw + pmaddwd
+	// Bе-128ָ϶-127㣨ݶ[-127, 127]ڣӰ죩
+	// C(A.N, A.C, M, N)·
+	CHAOS_EXPORT void GemmInt8(const Mat& A, const Mat& B, Mat& C, bool transA = false, bool transB = false);
+
+} // namespace chaos
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "def.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace chaos
+{
+	// 16λֻڴ洢ʱתΪfloat
+	// float16: IEEE 754 binary161λţ5λָ10λβ
+	// bfloat16: floatĸ16λ1λţ8λָ7λβΧfloatͬ
+	// floatתʱͽȡżNaNΪNaN
+
+	class float16
+	{
+	public:
+		float16() = default;
+		float16(float value) : bits(FromFloat(value)) {}
+		operator float() const { return ToFloat(bits); }
+
+		static float16 FromBits(uint16_t bits)
+		{
+			float16 value;
+			value.bits = bits;
+			return value;
+		}
+
+		static uint16_t FromFloat(float value)
+		{
+			uint32_t x;
+			memcpy(&x, &value, 4);
+			uint32_t sign = (x >> 16) & 0x8000;
+			x &= 0x7fffffff;
+
+			// ΧıΪInfNaNΪquiet NaN
+			if (x >= 0x47800000) return (uint16_t)(sign | (x > 0x7f800000 ? 0x7e00 : 0x7c00));
+			if (x < 0x38800000)
+			{
+				// Ƿǹӷ
+				float f;
+				memcpy(&f, &x, 4);
+				f += 0.5f;
+				memcpy(&x, &f, 4);
+				return (uint16_t)(sign | (x - 0x3f000000));
+			}
+			// ָƫƣβʱĽλȻָ
+			x += 0xc8000fff + ((x >> 13) & 1);
+			return (uint16_t)(sign | (x >> 13));
+		}
+
+		static float ToFloat(uint16_t bits)
+		{
+			uint32_t x = (uint32_t)(bits & 0x7fff) << 13;
+			uint32_t exp = x & 0x0f800000;
+			x += 0x38000000;
+			if (exp == 0x0f800000)
+			{
+				x += 0x38000000; // InfNaN
+			}
+			else if (exp == 0)
+			{
+				// ǹ
+				x += 0x00800000;
+				float f;
+				memcpy(&f, &x, 4);
+				f -= 6.103515625e-05f; // 2^-14
+				memcpy(&x, &f, 4);
+			}
+			x |= (uint32_t)(bits & 0x8000) << 16;
+
+			float value;
+			memcpy(&value, &x, 4);
+			return value;
+		}
+
+		uint16_t bits;
+	};
+
+	class bfloat16
+	{
+	public:
+		bfloat16() = default;
+		bfloat16(float value) : bits(FromFloat(value)) {}
+		operator float() const { return ToFloat(bits); }
+
+		static bfloat16 FromBits(uint16_t bits)
+		{
+			bfloat16 value;
+			value.bits = bits;
+			return value;
+		}
+
+		static uint16_t FromFloat(float value)
+		{
+			uint32_t x;
+			memcpy(&x, &value, 4);
+			if ((x & 0x7fffffff) > 0x7f800000) return (uint16_t)((x >> 16) | 0x0040);
+			x += 0x7fff + ((x >> 16) & 1);
+			return (uint16_t)(x >> 16);
+		}
+
+		static float ToFloat(uint16_t bits)
+		{
+			uint32_t x = (uint32_t)bits << 16;
+			float value;
+			memcpy(&value, &x, 4);
+			return value;
+		}
+
+		uint16_t bits;
+	};
+
+	static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2, "16-bit floats must be 2 bytes");
+
+	template<class Type>
+	class IsHalf : public std::integral_constant<bool,
+		std::is_same<Type, float16>::value || std::is_same<Type, bfloat16>::value> {};
+
+	// תǰָѡʵ֣F16CAVX512F֧ʱתָ޹
+	CHAOS_EXPORT void ToFloat(const float16* src, float* dst, size_t len);
+	CHAOS_EXPORT void ToFloat(const bfloat16* src, float* dst, size_t len);
+	CHAOS_EXPORT void FromFloat(const float* src, float16* dst, size_t len);
+	CHAOS_EXPORT void FromFloat(const float* src, bfloat16* dst, size_t len);
+
+} // namespace chaos
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 
 
 namespace chaos
@@ -19,6 +20,25 @@ namespace chaos
 
 		std::stringstream& Stream();
 
+		// FATALЧжϻᱻ
+		// ͷļֱӶlog_levelDLL֮Ĵ벻ֱӷʵ
+		static bool IsOn(LogSeverity severity);
+		static bool VerboseOn(int verbose_level);
+
+		// LOG_EVERY_NLOG_FIRST_NLOG_EVERY_TLOG_SAMPLEDÿõṩ
+		// n <= 0ʱnflagʱֵ
+		static bool EveryN(std::atomic<size_t>& counter, long long n)
+		{
+			return n > 0 && counter.fetch_add(1, std::memory_order_relaxed) % (size_t)n == 0;
+		}
+		static bool FirstN(std::atomic<size_t>& counter, size_t n)
+		{
+			return counter.load(std::memory_order_relaxed) < n && counter.fetch_add(1, std::memory_order_relaxed) < n;
+		}
+		// nextΪһʱ䣬λ
+		static bool EveryT(std::atomic<long long>& next, double seconds);
+		static bool Sample(double probability);
+
 	public:
 		static std::string log_name; // ־ļʱе־ͬһļ
 		static int log_level;
@@ -27,10 +47,8 @@ namespace chaos
 		void Flush();
 
 	private:
-		static std::mutex mtx;
 		static std::vector<std::string> log_severity_text;
 		std::stringstream message_data; // LogMessageData
-		time_t time_stamp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 
 		LogSeverity severity;
 	};
@@ -45,4 +63,6 @@ namespace chaos
 	};
 
 	CHAOS_EXPORT void InitLogging(const std::string argv0, int level = 0);
+	// ȴѾύ־ȫдֻ--log_asyncʱ
+	CHAOS_EXPORT void FlushLogging();
 }
\ No newline at end of file
@@ -1,8 +1,15 @@
 #pragma once
 
 #include "def.hpp"
+#include "log_message.hpp"
+#include "allocator.hpp"
+#include "half.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <initializer_list>
 #include <vector>
 #include <map>
 #include <memory>
@@ -10,6 +17,9 @@
 #include <iomanip>
 #include <typeindex>
 #include <functional>
+#include <iterator>
+#include <tuple>
+#include <utility>
 
 #ifdef USE_OPENCV
 #include <opencv2\opencv.hpp>
@@ -300,6 +310,11 @@ namespace chaos
 		Size operator()() const;
 		size_t operator[](size_t idx) const;
 
+		bool operator==(const MatSize& size) const;
+		bool operator!=(const MatSize& size) const;
+
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const MatSize& size);
+
 		size_t siz[4]; // NCHW
 	};
 
@@ -307,11 +322,14 @@ namespace chaos
 	{
 	public:
 		MatStep();
-		MatStep(const MatSize& siz);
+		// layoutʱĲ
+		MatStep(const MatSize& siz, MatLayout layout = LAYOUT_NCHW);
+		// ֱָÿһάĲڰװⲿĿ粽
+		MatStep(size_t num, size_t chs, size_t row, size_t col);
 
 		size_t operator[](size_t idx) const;
 
-		size_t stp[3];
+		size_t stp[4]; // NCHWÿһάĲλԪ
 		size_t slice_cnt;
 	};
 
@@ -327,34 +345,77 @@ namespace chaos
 
 		Mat(const size_t width, const size_t height, const MatDepth depth, void* data);
 		Mat(const std::vector<size_t> dims, const MatDepth depth, void* data);
-		Mat(const MatSize siz, const MatDepth depth, void* data);
+		// װⲿݣҲ
+		// NHWCݣOpenCVͼ񣩿ֱӰlayoutװҪ
+		Mat(const MatSize siz, const MatDepth depth, void* data, MatLayout layout = LAYOUT_NCHW);
+		Mat(const MatSize siz, const MatDepth depth, void* data, const MatStep& step);
 		Mat(const Size siz, const MatDepth depth, void* data);
 
 		Mat(const Mat& mtx, const Rect& roi);
 
 		Mat(const Mat& mtx);
 		Mat& operator=(const Mat& mtx);
+		// ƶֻתݵȨıü
+		Mat(Mat&& mtx) noexcept;
+		Mat& operator=(Mat&& mtx) noexcept;
 		Mat operator()(const Rect& roi);
 
+		// ͼԭMatݺü
+		// axis[start, end)Ĳ֣axisΪ0~3ӦNCHW
+		Mat Slice(size_t axis, size_t start, size_t end) const;
+		// [start, end)batch
+		Mat Batch(size_t start, size_t end) const;
+		// [start, end)ͨ
+		Mat Channels(size_t start, size_t end) const;
+		// ڴе˳½״Ԫ䣬Ҫǰlayoutе
+		Mat Reshape(const MatSize& siz) const;
+		// HWĲõתãƶ
+		Mat Transpose() const;
+
 		~Mat();
 
+		// ݣ״ȶͬʱֱӸеݣıԭе
+		// zero_fillΪfalseʱ㣬ϻᱻȫǵ
+		void Create(const MatSize siz, const MatDepth depth, bool zero_fill = true, MatLayout layout = LAYOUT_NCHW);
+
 		void Release();
-		// ʵroiĻȡٿcloneôʵ
+		// һеMatlayout
 		Mat Clone() const;
+		// dstdst״ͬʱֱд루ROI·
+		// ݺϲһοĿʹnon-temporal storeָ߳
+		void CopyTo(Mat& dst) const;
+
+		// ڴǷŵģʱԵһд
+		bool IsContinuous() const;
+
+		// ָlayoutݣlayoutͬʱͬڿ
+		void ToLayout(Mat& dst, MatLayout layout) const;
+
+		// dst = saturate(src * alpha + beta)depthΪDEPTH_UNKNOWʱԭ
+		void ConvertTo(Mat& dst, const MatDepth depth, double alpha = 1, double beta = 0) const;
+		// ͨһdst = (src * alpha - mean[c]) / stddev[c]һα
+		// meanstddevĳΪ1ߵͨ
+		void ConvertTo(Mat& dst, const MatDepth depth, const std::vector<double>& mean,
+			const std::vector<double>& stddev, double alpha = 1) const;
 
 		template<class Type>
 		Type* GetPtr(int num, int channel, int row, int col)
 		{
-			// Ա߽ж
-			CHECK(0 <= num && num < size[0]);
-			CHECK(0 <= channel && channel < size[1]);
-			CHECK(0 <= row && row < size[2]);
-			CHECK(0 <= col && col < size[3]);
+			// Ա߽жϣֻDebugЧ
+			DCHECK(0 <= num && num < size.siz[0]);
+			DCHECK(0 <= channel && channel < size.siz[1]);
+			DCHECK(0 <= row && row < size.siz[2]);
+			DCHECK(0 <= col && col < size.siz[3]);
 
 			auto ptr = (Type*)data_start;
-			ptr += (num * step[0] + channel * step[1] + row * step[2] + col);
+			ptr += (num * step.stp[0] + channel * step.stp[1] + row * step.stp[2] + col * step.stp[3]);
 			return ptr;
 		}
+		template<class Type>
+		const Type* GetPtr(int num, int channel, int row, int col) const
+		{
+			return const_cast<Mat*>(this)->GetPtr<Type>(num, channel, row, col);
+		}
 
 		//static Mat Zeros(const Size siz, const int depth);
 		//static Mat Ones(const Size siz, const int depth);
@@ -364,14 +425,112 @@ namespace chaos
 		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const Mat& mtx);
 		
 	public:
-		size_t* ref_cnt = nullptr;
+		std::atomic<size_t>* ref_cnt = nullptr; // ̹߳ͬһMatʱҲǰȫ
 		uchar* data;
 		uchar* data_start; // ʹݵʱ򣬵ʼָ루roi
 		uchar* data_end; // ֹʱô
 		MatSize size;
 		MatStep step;
 		MatDepth depth;
+		MatLayout layout = LAYOUT_NCHW; // ʱзʽͼԭMat
 		bool is_submatrix = false; // ǷӾ
+		MatAllocator* allocator = nullptr; // ΪʱʹMatAllocator::GetDefault()
+	};
+
+	// ͬʱбɸ״ͬMatһMatڴе˳ϲά
+	// ԪصںֻҪ rows x length һάݣÿڵԪضǽе
+	// Matзʽͬʱ˻ΪÿһԪ
+	// merge_slicesΪfalseʱͨάֻڲʱŻᲢһУڰͨȡں
+	class CHAOS_EXPORT MatRowIterator
+	{
+	public:
+		MatRowIterator(std::initializer_list<const Mat*> mtxs, bool merge_slices = true) :
+			mats(mtxs.begin(), mtxs.end())
+		{
+			Init(merge_slices);
+		}
+		MatRowIterator(const std::vector<const Mat*>& mtxs, bool merge_slices = true) : mats(mtxs)
+		{
+			Init(merge_slices);
+		}
+
+		// idxMatrowеʼַ
+		uchar* Ptr(size_t idx, size_t row) const
+		{
+			const Mat* mtx = mats[idx];
+			size_t offset = 0;
+			for (int i = outer_cnt - 1; i >= 0; i--)
+			{
+				int axis = outer[i];
+				offset += (row % mtx->size[axis]) * mtx->step[axis];
+				row /= mtx->size[axis];
+			}
+			return mtx->data_start + offset * elem_size[idx];
+		}
+
+		// rowڵͨchannel_innerΪtrueʱÿжͨ0ʼ
+		size_t Channel(size_t row) const
+		{
+			const MatSize& size = mats[0]->size;
+			for (int i = outer_cnt - 1; i >= 0; i--)
+			{
+				if (1 == outer[i]) return row % size[1];
+				row /= size[outer[i]];
+			}
+			return 0;
+		}
+
+		size_t rows; // 
+		size_t length; // ÿеԪظ
+		bool channel_inner = false; // һڰͨУNHWC
+
+	private:
+		void Init(bool merge_slices)
+		{
+			CHECK(!mats.empty());
+			for (auto mtx : mats) elem_size.push_back(ElemSize(mtx->depth));
+
+			// һMatĲ⵽ĸάȣСΪ1άȲӰ
+			const MatSize& size = mats[0]->size;
+			const MatStep& step = mats[0]->step;
+			int order[4] = { 0, 1, 2, 3 };
+			std::stable_sort(order, order + 4, [&](int a, int b) {
+				return (size[a] == 1 ? 0 : step[a]) > (size[b] == 1 ? 0 : step[b]); });
+
+			// ڲ㿪ʼϲҪMatЩά϶ǽܵ
+			std::vector<size_t> expected(mats.size(), 1);
+			int k = 3;
+			length = 1;
+			for (; k >= 0; k--)
+			{
+				int axis = order[k];
+				if (size[axis] == 1) continue;
+				if (!merge_slices && 1 == axis && 1 != length) break;
+
+				bool dense = true;
+				for (size_t m = 0; m < mats.size(); m++)
+					dense = dense && mats[m]->step[axis] == expected[m];
+				if (!dense) break;
+
+				if (1 == axis && 1 == length) channel_inner = true;
+				for (size_t m = 0; m < mats.size(); m++) expected[m] *= size[axis];
+				length *= size[axis];
+			}
+
+			rows = 1;
+			outer_cnt = 0;
+			for (int i = 0; i <= k; i++)
+			{
+				if (size[order[i]] == 1) continue;
+				outer[outer_cnt++] = order[i];
+				rows *= size[order[i]];
+			}
+		}
+
+		std::vector<const Mat*> mats;
+		std::vector<size_t> elem_size;
+		int outer[4]; // ܺϲάȣ⵽
+		int outer_cnt;
 	};
 
 #pragma region Data Depth
@@ -416,12 +575,198 @@ namespace chaos
 	public:
 		static constexpr MatDepth depth = DEPTH_64F;
 	};
+	template<> class DataDepth<float16>
+	{
+	public:
+		static constexpr MatDepth depth = DEPTH_16F;
+	};
+	template<> class DataDepth<bfloat16>
+	{
+	public:
+		static constexpr MatDepth depth = DEPTH_16BF;
+	};
+
+	// DataDepthķӳ䣬DepthType<DEPTH_32F>Ϊfloat
+	using DepthTypes = std::tuple<uchar, char, ushort, short, int, float, double, float16, bfloat16>;
+	template<MatDepth depth>
+	using DepthType = typename std::tuple_element<depth, DepthTypes>::type;
+
+	template<size_t... Idx>
+	constexpr bool CheckDepthTypes(std::index_sequence<Idx...>)
+	{
+		return ((DataDepth<typename std::tuple_element<Idx, DepthTypes>::type>::depth == (MatDepth)Idx &&
+			sizeof(typename std::tuple_element<Idx, DepthTypes>::type) == depth_infos[Idx].size &&
+			alignof(typename std::tuple_element<Idx, DepthTypes>::type) == depth_infos[Idx].alignment) && ...);
+	}
+	static_assert(std::tuple_size<DepthTypes>::value == depth_type_count && CheckDepthTypes(std::make_index_sequence<depth_type_count>()),
+		"DepthTypes, DataDepth and depth_infos do not match");
+
+	// DispatchDepthĻصĲdecltype(tag)::TypeȡԪ
+	template<class Type_>
+	class DepthTag
+	{
+	public:
+		using Type = Type_;
+	};
+
+	// ʱDepthTag<Type>funcںֻҪдɷlambdaģ壬Ϊÿдһswitch
+	//  DispatchDepth(mtx.depth, [&](auto tag) { Kernel<typename decltype(tag)::Type>(mtx); });
+	template<class Func>
+	void DispatchDepth(MatDepth depth, Func&& func)
+	{
+		switch (depth)
+		{
+		case DEPTH_8U: func(DepthTag<uchar>()); break;
+		case DEPTH_8S: func(DepthTag<char>()); break;
+		case DEPTH_16U: func(DepthTag<ushort>()); break;
+		case DEPTH_16S: func(DepthTag<short>()); break;
+		case DEPTH_32S: func(DepthTag<int>()); break;
+		case DEPTH_32F: func(DepthTag<float>()); break;
+		case DEPTH_64F: func(DepthTag<double>()); break;
+		case DEPTH_16F: func(DepthTag<float16>()); break;
+		case DEPTH_16BF: func(DepthTag<bfloat16>()); break;
+		default: LOG(FATAL) << "Unknown Depth Type";
+		}
+	}
 #pragma endregion
 
+	// һԪأֱڷΧforѭ
+	template<class Type>
+	class TMatSpan
+	{
+	public:
+		TMatSpan(Type* data, size_t length) : data(data), length(length) {}
+
+		Type* begin() const { return data; }
+		Type* end() const { return data + length; }
+		Type& operator[](size_t idx) const { return data[idx]; }
+		size_t Size() const { return length; }
+
+		Type* data;
+		size_t length;
+	};
+
+	// NCHW߼˳ԪأROIͲʵҪ
+	// ǰֻһβʱ¼ַ
+	template<class Type>
+	class TMatIterator
+	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = typename std::remove_const<Type>::type;
+		using difference_type = ptrdiff_t;
+		using pointer = Type*;
+		using reference = Type&;
+
+		TMatIterator() = default;
+		TMatIterator(const Mat* mtx, size_t pos = 0) : mtx(mtx)
+		{
+			Seek(pos);
+		}
+
+		reference operator*() const
+		{
+			DCHECK_LT(pos, Total()) << "Iterator out of range.";
+			return *ptr;
+		}
+		pointer operator->() const { return &**this; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		TMatIterator& operator++()
+		{
+			pos++;
+			if (++col < mtx->size.siz[3]) ptr += mtx->step.stp[3];
+			else Seek(pos);
+			return *this;
+		}
+		TMatIterator operator++(int)
+		{
+			TMatIterator it = *this;
+			++*this;
+			return it;
+		}
+		TMatIterator& operator--()
+		{
+			pos--;
+			if (col > 0 && col <= mtx->size.siz[3])
+			{
+				col--;
+				ptr -= mtx->step.stp[3];
+			}
+			else Seek(pos);
+			return *this;
+		}
+		TMatIterator operator--(int)
+		{
+			TMatIterator it = *this;
+			--*this;
+			return it;
+		}
+
+		TMatIterator& operator+=(difference_type n)
+		{
+			Seek(pos + n);
+			return *this;
+		}
+		TMatIterator& operator-=(difference_type n)
+		{
+			Seek(pos - n);
+			return *this;
+		}
+		friend TMatIterator operator+(TMatIterator it, difference_type n) { return it += n; }
+		friend TMatIterator operator+(difference_type n, TMatIterator it) { return it += n; }
+		friend TMatIterator operator-(TMatIterator it, difference_type n) { return it -= n; }
+		friend difference_type operator-(const TMatIterator& it1, const TMatIterator& it2)
+		{
+			return (difference_type)it1.pos - (difference_type)it2.pos;
+		}
+
+		friend bool operator==(const TMatIterator& it1, const TMatIterator& it2) { return it1.pos == it2.pos; }
+		friend bool operator!=(const TMatIterator& it1, const TMatIterator& it2) { return it1.pos != it2.pos; }
+		friend bool operator<(const TMatIterator& it1, const TMatIterator& it2) { return it1.pos < it2.pos; }
+		friend bool operator>(const TMatIterator& it1, const TMatIterator& it2) { return it1.pos > it2.pos; }
+		friend bool operator<=(const TMatIterator& it1, const TMatIterator& it2) { return it1.pos <= it2.pos; }
+		friend bool operator>=(const TMatIterator& it1, const TMatIterator& it2) { return it1.pos >= it2.pos; }
+
+		// ǰԪص߼ţ((n * C + c) * H + h) * W + w
+		size_t Position() const { return pos; }
+		size_t Total() const { return mtx->size.siz[0] * mtx->size.siz[1] * mtx->size.siz[2] * mtx->size.siz[3]; }
+
+	private:
+		void Seek(size_t idx)
+		{
+			pos = idx;
+			const size_t* siz = mtx->size.siz;
+			const size_t* stp = mtx->step.stp;
+			if (0 == Total())
+			{
+				ptr = nullptr;
+				col = 0;
+				return;
+			}
+
+			col = idx % siz[3];
+			idx /= siz[3];
+			size_t row = idx % siz[2];
+			idx /= siz[2];
+			size_t chs = idx % siz[1];
+			size_t num = idx / siz[1];
+			ptr = (Type*)mtx->data_start + num * stp[0] + chs * stp[1] + row * stp[2] + col * stp[3];
+		}
+
+		const Mat* mtx = nullptr;
+		Type* ptr = nullptr;
+		size_t pos = 0;
+		size_t col = 0; // ǰԪڵλ
+	};
+
 	template<class Type>
 	class TMat : public Mat
 	{
 	public:
+		using iterator = TMatIterator<Type>;
+		using const_iterator = TMatIterator<const Type>;
+
 		TMat() : Mat() {}
 
 		TMat(std::vector<size_t>&& dims) : Mat((dims), DataDepth<Type>::depth)
@@ -432,116 +777,152 @@ namespace chaos
 		{
 		}
 
+		TMat(const TMat<Type>& mtx) : Mat(mtx) {}
+		TMat(TMat<Type>&& mtx) noexcept : Mat(std::move(mtx)) {}
+
+		TMat<Type>& operator=(const TMat<Type>& mtx)
+		{
+			Mat::operator=(mtx);
+			return *this;
+		}
+		TMat<Type>& operator=(TMat<Type>&& mtx) noexcept
+		{
+			Mat::operator=(std::move(mtx));
+			return *this;
+		}
+
+		// ɱʽһμõmat_expr.hpp
+		template<class Expr>
+		TMat(const MatExpr<Expr>& expr) : Mat()
+		{
+			EvaluateExpr(expr, *this);
+		}
+		template<class Expr>
+		TMat<Type>& operator=(const MatExpr<Expr>& expr)
+		{
+			EvaluateExpr(expr, *this);
+			return *this;
+		}
+
 		template<class ValueType>
 		TMatInitializer<Type> operator<<(ValueType value)
 		{
 			TMatInitializer<Type> initializer(this);
 			return (initializer, value);
 		}
-	};
 
-	template<class Type>
-	class TMatIterator
-	{
-	public:
-		TMatIterator(TMat<Type>* mtx) : mtx(mtx)
+		// (num, channel)ƽrowеʼָ룬ԪصļΪstep.stp[3]NCHWʱΪ1
+		// ֻ߽Debug¼飬ڲѭֱӶָ
+		Type* Row(size_t num, size_t channel, size_t row)
+		{
+			DCHECK(num < size.siz[0] && channel < size.siz[1] && row < size.siz[2]) << "Row index out of range.";
+			return (Type*)data_start + num * step.stp[0] + channel * step.stp[1] + row * step.stp[2];
+		}
+		const Type* Row(size_t num, size_t channel, size_t row) const
 		{
-			ptr = it_start = (Type*)mtx->data;
+			return const_cast<TMat<Type>*>(this)->Row(num, channel, row);
 		}
 
-		template<class ValueType>
-		TMatIterator& operator=(ValueType value)
+		using Mat::operator();
+		Type& operator()(size_t num, size_t channel, size_t row, size_t col)
 		{
-			*ptr = (Type)value;
-			return *this;
+			DCHECK_LT(col, size.siz[3]) << "Col index out of range.";
+			return Row(num, channel, row)[col * step.stp[3]];
+		}
+		const Type& operator()(size_t num, size_t channel, size_t row, size_t col) const
+		{
+			return const_cast<TMat<Type>*>(this)->operator()(num, channel, row, col);
 		}
 
-		TMatIterator& operator++()
+		// ݷֳɶڴ棬ڴ˳νfunc(TMatSpan<Type>)
+		// TMatֻһΣROIÿһ
+		template<class Func>
+		void ForEachSpan(Func func)
 		{
-			ptr++;
-			return *this;
+			if (nullptr == data_start) return;
+			MatRowIterator it({ this });
+			for (size_t row = 0; row < it.rows; row++) func(TMatSpan<Type>((Type*)it.Ptr(0, row), it.length));
+		}
+		template<class Func>
+		void ForEachSpan(Func func) const
+		{
+			if (nullptr == data_start) return;
+			MatRowIterator it({ this });
+			for (size_t row = 0; row < it.rows; row++) func(TMatSpan<const Type>((const Type*)it.Ptr(0, row), it.length));
 		}
 
-	public:
-		Mat * mtx;
-		Type* it_start;
-		Type* it_end;
-		Type* ptr;
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, Total()); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, Total()); }
+
+		size_t Total() const { return size.siz[0] * size.siz[1] * size.siz[2] * size.siz[3]; }
 	};
 
+	// a << 1, 2, 3߼˳θֵROIҲдȷλ
 	template<class Type>
 	class TMatInitializer
 	{
 	public:
-		TMatInitializer(TMat<Type>* mtx) : it(mtx)
+		TMatInitializer(TMat<Type>* mtx) : mtx(mtx), it(mtx->begin())
 		{
 		}
 
 		template<class ValueType>
 		TMatInitializer& operator,(ValueType value)
 		{
-			it = value;
+			CHECK(it != mtx->end()) << "Too many values for the TMat.";
+			*it = (Type)value;
 			++it;
 			return *this;
 		}
 
 		operator TMat<Type>()
 		{
-			return *(TMat<Type>*)it.mtx;
+			return *mtx;
 		}
 
 	private:
+		TMat<Type>* mtx;
 		TMatIterator<Type> it;
 	};
 
 
-	class FormattedMat
+	// MatNCHWǶÿ㶼пʼָͽַ
+	class CHAOS_EXPORT FormattedMat
 	{
 	public:
-		enum State
-		{
-			STATE_PROLOGUE, STATE_EPILOGUE, 
-			STATE_CHANNEL_OPEN, STATE_CHANNEL_CLOSE, 
-			STATE_ROW_OPEN, STATE_ROW_CLOSE, 
-			STATE_VALUE, STATE_FINISHED, STATE_VALUE_SEPARATOR,
-			STATE_LINE_SEPARATOR, STATE_CHANNEL_SEPARATOR, STATE_NUM_SEPARATOR,
-		};
-
-		enum Brace
-		{
-			BRACE_ROW_OPEN, BRACE_ROW_CLOSE, 
-			BRACE_ROW_SEP, BRACE_CHANNEL_OPEN, 
-			BRACE_CHANNEL_CLOSE, BRACE_CHANNEL_SEP, 
-			BRACE_NUM_SEP,
+		class Style
+		{
+		public:
+			std::string prologue, epilogue;
+			std::string num_open, num_sep, num_close;
+			std::string channel_open, channel_sep, channel_close;
+			std::string row_open, row_sep, row_close;
+			std::string value_sep;
+			int precision = -1; // СλС0ʱܾȷԭʽ
+			size_t byte_width = 0; // 8λСȣಹո
 		};
 
-		FormattedMat(std::string pl, std::string el, const Mat& mtx, char br[7]);
+		FormattedMat(const Mat& mtx, const Style& style) : mtx(mtx), style(style) {}
 
-		friend std::ostream& operator<<(std::ostream& stream, const std::shared_ptr<FormattedMat>& formatted);	
+		// д뻺˲дstream
+		void Write(std::ostream& stream) const;
 
-		const std::string Next();
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const std::shared_ptr<FormattedMat>& formatted);
 
 		Mat mtx;
-		std::string prologue, epilogue;
-		char braces[7];
-		State state;
-		// NCHW
-		size_t num, channel, row, col; // row = h, col = w
-
-		char buff[32];   // enough for double with precision up to 20
-		std::function<void(void)> Convert;
-		void Convert8U() { sprintf_s(buff, "%3d", (int)mtx.GetPtr<uchar>(num, channel, row, 0)[col]); };
-		void Convert8S() { sprintf_s(buff, "%3d", (int)mtx.GetPtr<char>(num, channel, row, 0)[col]); };
-		void Convert16U() { sprintf_s(buff, "%d", mtx.GetPtr<ushort>(num, channel, row, 0)[col]); };
-		void Convert16S() { sprintf_s(buff, "%d", mtx.GetPtr<short>(num, channel, row, 0)[col]); };
-		void Convert32S() { sprintf_s(buff, "%d", mtx.GetPtr<int>(num, channel, row, 0)[col]); };
-		void Convert32F() { sprintf_s(buff, "%f", mtx.GetPtr<float>(num, channel, row, 0)[col]); };
-		void Convert64F() { sprintf_s(buff, "%lf", mtx.GetPtr<double>(num, channel, row, 0)[col]); };
+		Style style;
 	};
 
-	class MatFormatter
+	// MFT_DEFAULT   ÿƽһ[...]֮;ָ
+	// MFT_MATLAB    ֱMATLABУƽcat(3, ...)cat(4, ...)ƴ
+	// MFT_PYTHON    Ƕ׵listnp.array֮״ΪN x C x H x W
+	// MFT_CSV       ÿһ¼N * C * H
+	class CHAOS_EXPORT MatFormatter
 	{
 	public:
+		virtual ~MatFormatter() = default;
 		virtual std::shared_ptr<FormattedMat> Format(const Mat& mtx) = 0;
 
 		static std::shared_ptr<MatFormatter> Get(MatFormatType fmt = MFT_DEFAULT);
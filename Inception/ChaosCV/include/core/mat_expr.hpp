@@ -0,0 +1,357 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+#include "cpu.hpp"
+#include "simd.hpp"
+#include "arithmetic.hpp"
+
+#include <type_traits>
+
+namespace chaos
+{
+	// TMatıʽģ
+	// a * alpha + b - c ʽڱչһñʽֵTMatʱ
+	// һԼɣм䲻ʱMatÿֻһ
+	// ʹSIMD㣬͵мdouble棬󱥺ת
+	// ע: auto e = a + b; õǱʽTMateab
+
+	// ͵мdoubleÿһ
+	template<class Type>
+	using ExprWorkType = typename std::conditional<std::is_floating_point<Type>::value, Type, double>::type;
+
+	template<class Derived>
+	class MatExpr
+	{
+	public:
+		const Derived& Self() const { return static_cast<const Derived&>(*this); }
+	};
+
+	// Ҷӽڵ㣬һTMat
+	template<class Type>
+	class MatTerm : public MatExpr<MatTerm<Type>>
+	{
+	public:
+		using ValueType = Type;
+		using Work = ExprWorkType<Type>;
+		static constexpr bool vectorized = std::is_floating_point<Type>::value;
+
+		class Row
+		{
+		public:
+			Work operator[](size_t i) const { return (Work)ptr[i]; }
+			template<class V>
+			typename V::Reg Packet(size_t i) const { return V::Load(ptr + i); }
+
+			const Type* ptr;
+		};
+
+		MatTerm(const TMat<Type>& mtx) : mtx(mtx) {}
+
+		// õMatбסԼеλ
+		void Collect(std::vector<const Mat*>& mats) const
+		{
+			idx = mats.size();
+			mats.push_back(&mtx);
+		}
+		Row GetRow(const MatRowIterator& it, size_t row) const { return Row{ (const Type*)it.Ptr(idx, row) }; }
+		const MatSize* Size() const { return &mtx.size; }
+		void CheckSize(const MatSize& size) const
+		{
+			CHECK(mtx.size == size) << "Size mismatch in expression: " << mtx.size << " vs " << size << ".";
+		}
+
+	private:
+		const TMat<Type>& mtx;
+		mutable size_t idx = 0;
+	};
+
+	// ڵ㣬Զ㲥
+	template<class Type>
+	class MatScalar : public MatExpr<MatScalar<Type>>
+	{
+	public:
+		using ValueType = Type;
+		using Work = ExprWorkType<Type>;
+		static constexpr bool vectorized = std::is_floating_point<Type>::value;
+
+		class Row
+		{
+		public:
+			Work operator[](size_t) const { return value; }
+			template<class V>
+			typename V::Reg Packet(size_t) const { return V::Set1((Type)value); }
+
+			Work value;
+		};
+
+		template<class Scalar>
+		MatScalar(Scalar value) : value((Work)value) {}
+
+		void Collect(std::vector<const Mat*>&) const {}
+		Row GetRow(const MatRowIterator&, size_t) const { return Row{ value }; }
+		const MatSize* Size() const { return nullptr; }
+		void CheckSize(const MatSize&) const {}
+
+	private:
+		Work value;
+	};
+
+	template<class Op, class L, class R>
+	class MatBinaryExpr : public MatExpr<MatBinaryExpr<Op, L, R>>
+	{
+	public:
+		static_assert(std::is_same<typename L::ValueType, typename R::ValueType>::value,
+			"Operands of a Mat expression must have the same element type.");
+
+		using ValueType = typename L::ValueType;
+		using Work = ExprWorkType<ValueType>;
+		static constexpr bool vectorized = L::vectorized && R::vectorized;
+
+		class Row
+		{
+		public:
+			Work operator[](size_t i) const { return Op::Apply(left[i], right[i]); }
+			template<class V>
+			typename V::Reg Packet(size_t i) const
+			{
+				return Op::Apply(V(), left.template Packet<V>(i), right.template Packet<V>(i));
+			}
+
+			typename L::Row left;
+			typename R::Row right;
+		};
+
+		MatBinaryExpr(const L& left, const R& right) : left(left), right(right) {}
+
+		void Collect(std::vector<const Mat*>& mats) const
+		{
+			left.Collect(mats);
+			right.Collect(mats);
+		}
+		Row GetRow(const MatRowIterator& it, size_t row) const { return Row{ left.GetRow(it, row), right.GetRow(it, row) }; }
+		const MatSize* Size() const { return nullptr != left.Size() ? left.Size() : right.Size(); }
+		void CheckSize(const MatSize& size) const
+		{
+			left.CheckSize(size);
+			right.CheckSize(size);
+		}
+
+	private:
+		L left;
+		R right;
+	};
+
+	template<class Op, class E>
+	class MatUnaryExpr : public MatExpr<MatUnaryExpr<Op, E>>
+	{
+	public:
+		using ValueType = typename E::ValueType;
+		using Work = ExprWorkType<ValueType>;
+		static constexpr bool vectorized = E::vectorized;
+
+		class Row
+		{
+		public:
+			Work operator[](size_t i) const { return Op::Apply(expr[i]); }
+			template<class V>
+			typename V::Reg Packet(size_t i) const { return Op::Apply(V(), expr.template Packet<V>(i)); }
+
+			typename E::Row expr;
+		};
+
+		MatUnaryExpr(const E& expr) : expr(expr) {}
+
+		void Collect(std::vector<const Mat*>& mats) const { expr.Collect(mats); }
+		Row GetRow(const MatRowIterator& it, size_t row) const { return Row{ expr.GetRow(it, row) }; }
+		const MatSize* Size() const { return expr.Size(); }
+		void CheckSize(const MatSize& size) const { expr.CheckSize(size); }
+
+	private:
+		E expr;
+	};
+
+#pragma region Expression Operators
+	class ExprAdd
+	{
+	public:
+		template<class Work> static Work Apply(Work a, Work b) { return a + b; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a, typename V::Reg b) { return V::Add(a, b); }
+	};
+	class ExprSub
+	{
+	public:
+		template<class Work> static Work Apply(Work a, Work b) { return a - b; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a, typename V::Reg b) { return V::Sub(a, b); }
+	};
+	class ExprMul
+	{
+	public:
+		template<class Work> static Work Apply(Work a, Work b) { return a * b; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a, typename V::Reg b) { return V::Mul(a, b); }
+	};
+	class ExprDiv
+	{
+	public:
+		template<class Work> static Work Apply(Work a, Work b) { return a / b; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a, typename V::Reg b) { return V::Div(a, b); }
+	};
+	class ExprMin
+	{
+	public:
+		template<class Work> static Work Apply(Work a, Work b) { return b < a ? b : a; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a, typename V::Reg b) { return V::Min(a, b); }
+	};
+	class ExprMax
+	{
+	public:
+		template<class Work> static Work Apply(Work a, Work b) { return a < b ? b : a; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a, typename V::Reg b) { return V::Max(a, b); }
+	};
+	class ExprNeg
+	{
+	public:
+		template<class Work> static Work Apply(Work a) { return -a; }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a) { return V::Sub(V::Set1(0), a); }
+	};
+	class ExprAbs
+	{
+	public:
+		template<class Work> static Work Apply(Work a) { return std::abs(a); }
+		template<class V> static typename V::Reg Apply(V, typename V::Reg a) { return V::Abs(a); }
+	};
+#pragma endregion
+
+#pragma region Expression Builders
+	template<class Type> class IsMatOperand
+	{
+	public:
+		static constexpr bool value = std::is_base_of<MatExpr<Type>, Type>::value;
+	};
+	template<class Type> class IsMatOperand<TMat<Type>>
+	{
+	public:
+		static constexpr bool value = true;
+	};
+
+	template<class Type> class ExprValueType
+	{
+	public:
+		using type = typename Type::ValueType;
+	};
+	template<class Type> class ExprValueType<TMat<Type>>
+	{
+	public:
+		using type = Type;
+	};
+
+	template<class Type>
+	MatTerm<Type> ToExpr(const TMat<Type>& mtx) { return MatTerm<Type>(mtx); }
+	template<class Expr>
+	const Expr& ToExpr(const MatExpr<Expr>& expr) { return expr.Self(); }
+
+	template<class Op, class L, class R>
+	MatBinaryExpr<Op, L, R> MakeBinaryExpr(const L& left, const R& right) { return MatBinaryExpr<Op, L, R>(left, right); }
+
+	// 󡢾ʽ
+#define CHAOS_MAT_EXPR_BINARY(name, Op)																\
+	template<class L, class R, typename std::enable_if<												\
+		IsMatOperand<L>::value && IsMatOperand<R>::value, int>::type = 0>							\
+	auto name(const L& left, const R& right)														\
+	{																								\
+		return MakeBinaryExpr<Op>(ToExpr(left), ToExpr(right));										\
+	}																								\
+	template<class L, class R, typename std::enable_if<												\
+		IsMatOperand<L>::value && std::is_arithmetic<R>::value, int>::type = 0>						\
+	auto name(const L& left, R right)																\
+	{																								\
+		return MakeBinaryExpr<Op>(ToExpr(left), MatScalar<typename ExprValueType<L>::type>(right));	\
+	}																								\
+	template<class L, class R, typename std::enable_if<												\
+		std::is_arithmetic<L>::value && IsMatOperand<R>::value, int>::type = 0>						\
+	auto name(L left, const R& right)																\
+	{																								\
+		return MakeBinaryExpr<Op>(MatScalar<typename ExprValueType<R>::type>(left), ToExpr(right));	\
+	}
+
+	CHAOS_MAT_EXPR_BINARY(operator+, ExprAdd)
+	CHAOS_MAT_EXPR_BINARY(operator-, ExprSub)
+	CHAOS_MAT_EXPR_BINARY(operator*, ExprMul)
+	CHAOS_MAT_EXPR_BINARY(operator/, ExprDiv)
+	CHAOS_MAT_EXPR_BINARY(Min, ExprMin)
+	CHAOS_MAT_EXPR_BINARY(Max, ExprMax)
+
+#undef CHAOS_MAT_EXPR_BINARY
+
+	template<class E, typename std::enable_if<IsMatOperand<E>::value, int>::type = 0>
+	auto operator-(const E& expr)
+	{
+		auto e = ToExpr(expr);
+		return MatUnaryExpr<ExprNeg, decltype(e)>(e);
+	}
+
+	template<class E, typename std::enable_if<IsMatOperand<E>::value, int>::type = 0>
+	auto Abs(const E& expr)
+	{
+		auto e = ToExpr(expr);
+		return MatUnaryExpr<ExprAbs, decltype(e)>(e);
+	}
+#pragma endregion
+
+#pragma region Evaluation
+	// matsǱʽеĲһdstһڴ˳
+	template<class ISA, class Type, class Expr>
+	void EvaluateRows(const Expr& expr, const std::vector<const Mat*>& mats, TMat<Type>& dst)
+	{
+		MatRowIterator it(mats);
+		size_t length = it.length;
+		for (size_t row = 0; row < it.rows; row++)
+		{
+			auto src = expr.GetRow(it, row);
+			Type* out = (Type*)it.Ptr(mats.size() - 1, row);
+
+			size_t i = 0;
+			if constexpr (Expr::vectorized && !std::is_same<ISA, simd::Scalar>::value)
+			{
+				using V = simd::Vec<ISA, Type>;
+				for (; i + V::lanes <= length; i += V::lanes)
+				{
+					V::Store(out + i, src.template Packet<V>(i));
+				}
+			}
+			for (; i < length; i++)
+			{
+				out[i] = SaturateCast<Type>(src[i]);
+			}
+		}
+	}
+
+	// Ԫؼ㣬dstǱʽеĲ
+	template<class Type, class Expr>
+	void EvaluateExpr(const MatExpr<Expr>& e, TMat<Type>& dst)
+	{
+		const Expr& expr = e.Self();
+		CHECK(nullptr != expr.Size()) << "Expression has no Mat operand.";
+		MatSize size = *expr.Size();
+		expr.CheckSize(size);
+
+		std::vector<const Mat*> mats;
+		expr.Collect(mats);
+		dst.Create(size, DataDepth<Type>::depth, false, mats[0]->layout);
+		mats.push_back(&dst);
+
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			EvaluateRows<simd::AVX512>(expr, mats, dst); break;
+		case SIMD_AVX2:
+			EvaluateRows<simd::AVX2>(expr, mats, dst); break;
+		case SIMD_SSE2:
+			EvaluateRows<simd::SSE2>(expr, mats, dst); break;
+		default:
+			EvaluateRows<simd::Scalar>(expr, mats, dst); break;
+		}
+	}
+#pragma endregion
+
+} // namespace chaos
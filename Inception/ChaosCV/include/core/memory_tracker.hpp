@@ -0,0 +1,108 @@
+#pragma once
+
+#include "def.hpp"
+#include "allocator.hpp"
+#include "mat.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace chaos
+{
+	// MatݿڴͳƣMat::CreateMat::Release
+	// ֵͰȵͳʼտֻǼԭӲ
+	// --track_memory򿪺¼ÿݿ״ǩڵ֡ڰ״/ǩͳƺͲûͷŵMat
+	// ֽMatʵʹõĴСڴضĲּAllocatorStats
+
+	class MemoryUsage
+	{
+	public:
+		size_t count = 0; // ǰݿ
+		size_t bytes = 0; // ǰֽ
+		size_t peak_bytes = 0; // ֻа״ͱǩͳзֵ
+		size_t allocations = 0; // ۼƷĴ
+	};
+
+	class CHAOS_EXPORT MemoryRecord
+	{
+	public:
+		MatSize size;
+		MatDepth depth = DEPTH_UNKNOW;
+		size_t bytes = 0;
+		std::string tag;
+		size_t frame = 0; // ʱ֡
+
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const MemoryRecord& record);
+	};
+
+	class CHAOS_EXPORT MemoryStats
+	{
+	public:
+		size_t live_bytes = 0;
+		size_t peak_bytes = 0;
+		size_t live_count = 0;
+		size_t allocations = 0;
+		size_t deallocations = 0;
+
+		std::map<MatDepth, MemoryUsage> depths;
+		// ֻ--track_memoryʱ
+		std::map<std::string, MemoryUsage> shapes; // "1x3x224x224 32F"
+		std::map<std::string, MemoryUsage> tags;
+
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const MemoryStats& stats);
+	};
+
+	class CHAOS_EXPORT MemoryTracker
+	{
+	public:
+		static bool IsEnabled();
+		// ͬ--track_memoryֻ֮ݿЧ
+		static void SetEnabled(bool enabled);
+
+		static size_t LiveBytes();
+		static size_t PeakBytes();
+		// ѷֵΪǰĴֽͳĳһδķֵ
+		static void ResetPeak();
+
+		static MemoryStats Stats();
+
+		// ֡żһµ֡ţÿһ֡ʼʱ
+		static size_t NextFrame();
+		static size_t Frame();
+		// before_frame֮ǰȻݿ飬˳
+		static std::vector<MemoryRecord> LiveAllocations(size_t before_frame = (size_t)-1);
+
+		// ͨLOG(INFO)Statsmax_shapesΪ״ֽ
+		static void Dump(size_t max_shapes = 16);
+		// ͨLOG(WARNING)before_frame֮ǰȻݿ
+		static void DumpLive(size_t before_frame = (size_t)-1, size_t max_records = 32);
+
+		// ǰ̵߳ķǩnameַ֮ǰıǩ
+		static const char* SetTag(const char* name);
+
+		static void OnAllocate(MatBlock* block, const MatSize& size, MatDepth depth, size_t bytes);
+		static void OnRelease(MatBlock* block);
+	};
+
+	// ڵǰ̷߳Matnameıǩ
+	class MemoryTag
+	{
+	public:
+		MemoryTag(const char* name) : previous(MemoryTracker::SetTag(name)) {}
+		~MemoryTag() { MemoryTracker::SetTag(previous); }
+
+		MemoryTag(const MemoryTag&) = delete;
+		MemoryTag& operator=(const MemoryTag&) = delete;
+
+	private:
+		const char* previous;
+	};
+
+} // namespace chaos
+
+#define CHAOS_MEMORY_TAG_CONCAT_IMPL(a, b) a##b
+#define CHAOS_MEMORY_TAG_CONCAT(a, b) CHAOS_MEMORY_TAG_CONCAT_IMPL(a, b)
+#define CHAOS_MEMORY_TAG(name)								\
+  chaos::MemoryTag CHAOS_MEMORY_TAG_CONCAT(memory_tag_, __LINE__)(name)
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "def.hpp"
+
+#include <functional>
+
+namespace chaos
+{
+	class Mat;
+
+	// ҿ[begin, end)
+	class Range
+	{
+	public:
+		Range() : begin(0), end(0) {}
+		Range(size_t begin, size_t end) : begin(begin), end(end) {}
+
+		size_t Size() const { return end > begin ? end - begin : 0; }
+		bool Empty() const { return end <= begin; }
+
+		size_t begin;
+		size_t end;
+	};
+
+	// ʹọ̃߳߳Ĭ-num_threads0ʾʹȫ
+	CHAOS_EXPORT size_t GetNumThreads();
+	// ߳ؽ̳߳أҪڲѭִʱ
+	CHAOS_EXPORT void SetNumThreads(size_t threads);
+
+	// rangeгɲСgrainɶΣ̳߳أȡִbodyʱжζ
+	// ڲڲٵʱֱڵǰ̴ִ߳
+	CHAOS_EXPORT void ParallelFor(const Range& range, size_t grain, const std::function<void(const Range&)>& body);
+
+	// ƽ滮֣Ϊn * C + cN * C
+	CHAOS_EXPORT void ParallelForSlices(const Mat& mtx, const std::function<void(const Range& slices)>& body);
+	// л֣Ϊ(n * C + c) * H + hÿgrain
+	CHAOS_EXPORT void ParallelForRows(const Mat& mtx, size_t grain, const std::function<void(const Range& rows)>& body);
+	// ÿƽгtileСĿ飬bodyյƽźͿƽеλãԵĿСһЩ
+	CHAOS_EXPORT void ParallelForTiles(const Mat& mtx, const Size& tile, const std::function<void(size_t slice, const Rect& roi)>& body);
+
+} // namespace chaos
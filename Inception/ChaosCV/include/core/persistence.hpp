@@ -0,0 +1,69 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace chaos
+{
+	// ƵMatļԴŶMat
+	// ļͷ֮ǸMatݣÿݶ64ֽڶ룬layout
+	// м¼״ȡкݵУֻ֧ͣС
+	//
+	// | MatFileHeader | MatFileEntry x count | 0 | 1 | ...
+
+	// ֻһMatΪ
+	CHAOS_EXPORT void SaveMat(const std::string& file, const Mat& mtx);
+	// ȡļеĵһMatݿ·Mat
+	CHAOS_EXPORT Mat LoadMat(const std::string& file);
+
+	// 63ַROIȲMatȿд
+	CHAOS_EXPORT void SaveMats(const std::string& file, const std::map<std::string, Mat>& mats);
+	CHAOS_EXPORT std::map<std::string, Mat> LoadMats(const std::string& file);
+
+	// ļӳ䵽ڴУGetõMatֱָӳҳ棬
+	// ҳֻڵһηʱŴӴ̶룬ʺʱشȨغͱ궨
+	// ӳдʱƵģ޸MatıļMatӳڣMappedMatFile֮ǰ
+	class CHAOS_EXPORT MappedMatFile
+	{
+	public:
+		// verifyΪtrueʱʱУݣļ
+		MappedMatFile(const std::string& file, bool verify = false);
+		~MappedMatFile();
+
+		MappedMatFile(const MappedMatFile&) = delete;
+		MappedMatFile& operator=(const MappedMatFile&) = delete;
+
+		Mat Get(const std::string& name) const;
+		bool Contains(const std::string& name) const;
+		std::vector<std::string> Names() const;
+		size_t Size() const { return entries.size(); }
+
+		// УĳMatݣһʱfalse
+		bool Verify(const std::string& name) const;
+
+	private:
+		class Entry
+		{
+		public:
+			MatSize size;
+			MatDepth depth;
+			MatLayout layout;
+			size_t offset;
+			size_t bytes;
+			uint64_t checksum;
+		};
+
+		const Entry& Find(const std::string& name) const;
+
+		std::string file;
+		uchar* base = nullptr;
+		size_t length = 0;
+		void* handle = nullptr; // ƽ̨صӳ
+		std::map<std::string, Entry> entries;
+	};
+
+} // namespace chaos
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "def.hpp"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace chaos
+{
+	// ĺʱͳƣ--profileʱż¼رʱÿֻһκúж
+	//   CHAOS_PROFILE_SCOPE("Gemm");
+	// ÿ̰߳¼׷ӵԼĻУ¼ʱnameַ
+	// ÿ߳ౣ--profile_max_events¼֮¼ֻ
+
+	class CHAOS_EXPORT ProfileStats
+	{
+	public:
+		std::string name;
+		size_t count = 0;
+		// λ
+		double total = 0;
+		double mean = 0;
+		double p50 = 0;
+		double p99 = 0;
+		double max = 0;
+
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const ProfileStats& stats);
+	};
+
+	class CHAOS_EXPORT Profiler
+	{
+	public:
+		static bool IsEnabled();
+		// ͬ--profile
+		static void SetEnabled(bool enabled);
+
+		// ̵ֻ߳¼ܺʱӴС
+		static std::vector<ProfileStats> Stats();
+		// ͨLOG(INFO)Stats
+		static void Report();
+		// ΪChrometrace eventʽchrome://tracingPerfettoд
+		static void ExportChromeTrace(const std::string& file);
+		// Ѿ¼¼Ҫ̻߳ڼ¼ʱ
+		static void Clear();
+		// ޺ûм¼¼
+		static size_t DroppedEvents();
+
+		static long long Now();
+		static void Record(const char* name, long long begin, long long end);
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name) : name(Profiler::IsEnabled() ? name : nullptr)
+		{
+			if (nullptr != this->name) begin = Profiler::Now();
+		}
+		~ProfileScope()
+		{
+			if (nullptr != name) Profiler::Record(name, begin, Profiler::Now());
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* name;
+		long long begin = 0;
+	};
+
+} // namespace chaos
+
+#define CHAOS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CHAOS_PROFILE_CONCAT(a, b) CHAOS_PROFILE_CONCAT_IMPL(a, b)
+#define CHAOS_PROFILE_SCOPE(name)							\
+  chaos::ProfileScope CHAOS_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
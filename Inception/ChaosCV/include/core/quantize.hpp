@@ -0,0 +1,62 @@
+#pragma once
+
+#include "def.hpp"
+#include "mat.hpp"
+
+#include <vector>
+#include <iostream>
+
+namespace chaos
+{
+	// INT8real = (q - zero_point) * scale
+	// ֵķΧΪ[-127, 127]NCNNһ£int8ĵpmaddubswᱥ
+	// Matһ飬Ҳaxisͨһ飺axisΪ1ӦͼͨΪ0Ӧ˵ͨ
+
+	class CHAOS_EXPORT QuantParam
+	{
+	public:
+		QuantParam() = default;
+		// Matһ
+		QuantParam(float scale, int zero_point = 0) : scale({ scale }), zero_point({ zero_point }) {}
+		// axisͨzero_pointΪʱΪ0
+		QuantParam(const std::vector<float>& scale, const std::vector<int>& zero_point, int axis)
+			: scale(scale), zero_point(zero_point.empty() ? std::vector<int>(scale.size(), 0) : zero_point), axis(axis) {}
+
+		bool PerChannel() const { return axis >= 0; }
+		// еzero_pointΪ0
+		bool IsSymmetric() const;
+
+		// [min, max]0ķǶԳƲ
+		static QuantParam FromRange(float min, float max);
+		// srcDEPTH_32FȡֵΧaxisΪ-1ʱMatһ
+		// symmetricΪtrueʱzero_pointΪ0scale = max(|x|) / 127һȨ
+		static QuantParam Calibrate(const Mat& src, int axis = -1, bool symmetric = true);
+
+		std::vector<float> scale;
+		std::vector<int> zero_point;
+		int axis = -1; // -1ʾͨ
+
+		CHAOS_EXPORT friend std::ostream& operator<<(std::ostream& stream, const QuantParam& param);
+	};
+
+	// DEPTH_8SMatͼͿϲҪʱ°װ
+	class CHAOS_EXPORT QMat : public Mat
+	{
+	public:
+		QMat() = default;
+		QMat(const MatSize& size, const QuantParam& param, MatLayout layout = LAYOUT_NCHW);
+		// װѾõݣNCNNȨأ
+		QMat(const Mat& mtx, const QuantParam& param);
+
+		QuantParam param;
+	};
+
+	// dst = clamp(rint(src * (1 / scale) + zero_point), -127, 127)srcΪDEPTH_32FNaNΪ-127
+	CHAOS_EXPORT void Quantize(const Mat& src, QMat& dst, const QuantParam& param);
+	// dst = (src - zero_point) * scaledstΪDEPTH_32F
+	CHAOS_EXPORT void Dequantize(const QMat& src, Mat& dst);
+	// int8ۼӽDEPTH_32SΪDEPTH_32Fdst = src * scale[c] + shift[c]
+	// axisͬQuantParamGEMMָ֮ͨʱbiaszero_pointĲshift
+	CHAOS_EXPORT void Dequantize(const Mat& src, Mat& dst, const std::vector<float>& scale, const std::vector<float>& shift, int axis = -1);
+
+} // namespace chaos
@@ -0,0 +1,736 @@
+#pragma once
+
+#include "def.hpp"
+#include "half.hpp"
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace chaos
+{
+	namespace simd
+	{
+		// ָǩʱGetSimdLevel()ʹһ
+		struct Scalar {};
+		struct SSE2 {};
+		struct AVX2 {};
+		struct AVX512 {};
+
+		// Vec<ISA, Type>ԼĴļ򵥷װ
+		// : Add/Sub8λ16λǱ㣬32λǻ
+		// : ṩMul/Div/FMA
+		template<class ISA, class Type> struct Vec;
+
+#pragma region SSE2
+		template<> struct Vec<SSE2, float>
+		{
+			using Reg = __m128;
+			static constexpr size_t lanes = 4;
+
+			static Reg Load(const float* ptr) { return _mm_loadu_ps(ptr); }
+			static void Store(float* ptr, Reg a) { _mm_storeu_ps(ptr, a); }
+			static Reg Set1(float value) { return _mm_set1_ps(value); }
+
+			static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+			static Reg FMA(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+			static Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+			static Reg Abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+		};
+
+		template<> struct Vec<SSE2, double>
+		{
+			using Reg = __m128d;
+			static constexpr size_t lanes = 2;
+
+			static Reg Load(const double* ptr) { return _mm_loadu_pd(ptr); }
+			static void Store(double* ptr, Reg a) { _mm_storeu_pd(ptr, a); }
+			static Reg Set1(double value) { return _mm_set1_pd(value); }
+
+			static Reg Add(Reg a, Reg b) { return _mm_add_pd(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_sub_pd(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm_mul_pd(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm_div_pd(a, b); }
+			static Reg FMA(Reg a, Reg b, Reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+			static Reg Min(Reg a, Reg b) { return _mm_min_pd(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm_max_pd(a, b); }
+			static Reg Abs(Reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.), a); }
+		};
+
+		// ͹õĶд
+		template<class Type> struct VecSSE2Int
+		{
+			using Reg = __m128i;
+			static constexpr size_t lanes = 16 / sizeof(Type);
+
+			static Reg Load(const Type* ptr) { return _mm_loadu_si128((const __m128i*)ptr); }
+			static void Store(Type* ptr, Reg a) { _mm_storeu_si128((__m128i*)ptr, a); }
+			// ab֮ѡmaskΪȫ1ʱѡb
+			static Reg Select(Reg mask, Reg a, Reg b) { return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a)); }
+		};
+
+		template<> struct Vec<SSE2, uchar> : VecSSE2Int<uchar>
+		{
+			static Reg Set1(uchar value) { return _mm_set1_epi8((char)value); }
+			static Reg Add(Reg a, Reg b) { return _mm_adds_epu8(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_subs_epu8(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm_min_epu8(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm_max_epu8(a, b); }
+			static Reg Abs(Reg a) { return a; }
+		};
+
+		template<> struct Vec<SSE2, char> : VecSSE2Int<char>
+		{
+			static Reg Set1(char value) { return _mm_set1_epi8(value); }
+			static Reg Add(Reg a, Reg b) { return _mm_adds_epi8(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_subs_epi8(a, b); }
+			// SSE2ûз8λmin/max
+			static Reg Min(Reg a, Reg b) { return Select(_mm_cmpgt_epi8(a, b), a, b); }
+			static Reg Max(Reg a, Reg b) { return Select(_mm_cmpgt_epi8(b, a), a, b); }
+			static Reg Abs(Reg a) { return Max(a, _mm_subs_epi8(_mm_setzero_si128(), a)); }
+		};
+
+		template<> struct Vec<SSE2, ushort> : VecSSE2Int<ushort>
+		{
+			static Reg Set1(ushort value) { return _mm_set1_epi16((short)value); }
+			static Reg Add(Reg a, Reg b) { return _mm_adds_epu16(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_subs_epu16(a, b); }
+			// min(a, b) = a - max(a - b, 0)
+			static Reg Min(Reg a, Reg b) { return _mm_sub_epi16(a, _mm_subs_epu16(a, b)); }
+			static Reg Max(Reg a, Reg b) { return _mm_add_epi16(b, _mm_subs_epu16(a, b)); }
+			static Reg Abs(Reg a) { return a; }
+		};
+
+		template<> struct Vec<SSE2, short> : VecSSE2Int<short>
+		{
+			static Reg Set1(short value) { return _mm_set1_epi16(value); }
+			static Reg Add(Reg a, Reg b) { return _mm_adds_epi16(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_subs_epi16(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm_min_epi16(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm_max_epi16(a, b); }
+			static Reg Abs(Reg a) { return _mm_max_epi16(a, _mm_subs_epi16(_mm_setzero_si128(), a)); }
+		};
+
+		template<> struct Vec<SSE2, int> : VecSSE2Int<int>
+		{
+			static Reg Set1(int value) { return _mm_set1_epi32(value); }
+			static Reg Add(Reg a, Reg b) { return _mm_add_epi32(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_sub_epi32(a, b); }
+			static Reg Min(Reg a, Reg b) { return Select(_mm_cmpgt_epi32(a, b), a, b); }
+			static Reg Max(Reg a, Reg b) { return Select(_mm_cmpgt_epi32(b, a), a, b); }
+			static Reg Abs(Reg a)
+			{
+				Reg sign = _mm_srai_epi32(a, 31);
+				return _mm_sub_epi32(_mm_xor_si128(a, sign), sign);
+			}
+		};
+#pragma endregion
+
+#pragma region AVX2
+		template<> struct Vec<AVX2, float>
+		{
+			using Reg = __m256;
+			static constexpr size_t lanes = 8;
+
+			static Reg Load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+			static void Store(float* ptr, Reg a) { _mm256_storeu_ps(ptr, a); }
+			static Reg Set1(float value) { return _mm256_set1_ps(value); }
+
+			static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+			static Reg FMA(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+			static Reg Abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+		};
+
+		template<> struct Vec<AVX2, double>
+		{
+			using Reg = __m256d;
+			static constexpr size_t lanes = 4;
+
+			static Reg Load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+			static void Store(double* ptr, Reg a) { _mm256_storeu_pd(ptr, a); }
+			static Reg Set1(double value) { return _mm256_set1_pd(value); }
+
+			static Reg Add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm256_div_pd(a, b); }
+			static Reg FMA(Reg a, Reg b, Reg c) { return _mm256_fmadd_pd(a, b, c); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+			static Reg Abs(Reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.), a); }
+		};
+
+		template<class Type> struct VecAVX2Int
+		{
+			using Reg = __m256i;
+			static constexpr size_t lanes = 32 / sizeof(Type);
+
+			static Reg Load(const Type* ptr) { return _mm256_loadu_si256((const __m256i*)ptr); }
+			static void Store(Type* ptr, Reg a) { _mm256_storeu_si256((__m256i*)ptr, a); }
+		};
+
+		template<> struct Vec<AVX2, uchar> : VecAVX2Int<uchar>
+		{
+			static Reg Set1(uchar value) { return _mm256_set1_epi8((char)value); }
+			static Reg Add(Reg a, Reg b) { return _mm256_adds_epu8(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_subs_epu8(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_epu8(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_epu8(a, b); }
+			static Reg Abs(Reg a) { return a; }
+		};
+
+		template<> struct Vec<AVX2, char> : VecAVX2Int<char>
+		{
+			static Reg Set1(char value) { return _mm256_set1_epi8(value); }
+			static Reg Add(Reg a, Reg b) { return _mm256_adds_epi8(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_subs_epi8(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_epi8(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_epi8(a, b); }
+			// abs(-128)Ϊ127·һ
+			static Reg Abs(Reg a) { return _mm256_max_epi8(a, _mm256_subs_epi8(_mm256_setzero_si256(), a)); }
+		};
+
+		template<> struct Vec<AVX2, ushort> : VecAVX2Int<ushort>
+		{
+			static Reg Set1(ushort value) { return _mm256_set1_epi16((short)value); }
+			static Reg Add(Reg a, Reg b) { return _mm256_adds_epu16(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_subs_epu16(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_epu16(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_epu16(a, b); }
+			static Reg Abs(Reg a) { return a; }
+		};
+
+		template<> struct Vec<AVX2, short> : VecAVX2Int<short>
+		{
+			static Reg Set1(short value) { return _mm256_set1_epi16(value); }
+			static Reg Add(Reg a, Reg b) { return _mm256_adds_epi16(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_subs_epi16(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_epi16(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_epi16(a, b); }
+			static Reg Abs(Reg a) { return _mm256_max_epi16(a, _mm256_subs_epi16(_mm256_setzero_si256(), a)); }
+		};
+
+		template<> struct Vec<AVX2, int> : VecAVX2Int<int>
+		{
+			static Reg Set1(int value) { return _mm256_set1_epi32(value); }
+			static Reg Add(Reg a, Reg b) { return _mm256_add_epi32(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_sub_epi32(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_epi32(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_epi32(a, b); }
+			static Reg Abs(Reg a) { return _mm256_abs_epi32(a); }
+		};
+#pragma endregion
+
+#pragma region AVX512
+		template<> struct Vec<AVX512, float>
+		{
+			using Reg = __m512;
+			static constexpr size_t lanes = 16;
+
+			static Reg Load(const float* ptr) { return _mm512_loadu_ps(ptr); }
+			static void Store(float* ptr, Reg a) { _mm512_storeu_ps(ptr, a); }
+			static Reg Set1(float value) { return _mm512_set1_ps(value); }
+
+			static Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+			static Reg FMA(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+			static Reg Abs(Reg a) { return _mm512_abs_ps(a); }
+		};
+
+		template<> struct Vec<AVX512, double>
+		{
+			using Reg = __m512d;
+			static constexpr size_t lanes = 8;
+
+			static Reg Load(const double* ptr) { return _mm512_loadu_pd(ptr); }
+			static void Store(double* ptr, Reg a) { _mm512_storeu_pd(ptr, a); }
+			static Reg Set1(double value) { return _mm512_set1_pd(value); }
+
+			static Reg Add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+			static Reg Div(Reg a, Reg b) { return _mm512_div_pd(a, b); }
+			static Reg FMA(Reg a, Reg b, Reg c) { return _mm512_fmadd_pd(a, b, c); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_pd(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_pd(a, b); }
+			static Reg Abs(Reg a) { return _mm512_abs_pd(a); }
+		};
+
+		template<class Type> struct VecAVX512Int
+		{
+			using Reg = __m512i;
+			static constexpr size_t lanes = 64 / sizeof(Type);
+
+			static Reg Load(const Type* ptr) { return _mm512_loadu_si512(ptr); }
+			static void Store(Type* ptr, Reg a) { _mm512_storeu_si512(ptr, a); }
+		};
+
+		// 8λ16λҪAVX512BW
+		template<> struct Vec<AVX512, uchar> : VecAVX512Int<uchar>
+		{
+			static Reg Set1(uchar value) { return _mm512_set1_epi8((char)value); }
+			static Reg Add(Reg a, Reg b) { return _mm512_adds_epu8(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_subs_epu8(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_epu8(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_epu8(a, b); }
+			static Reg Abs(Reg a) { return a; }
+		};
+
+		template<> struct Vec<AVX512, char> : VecAVX512Int<char>
+		{
+			static Reg Set1(char value) { return _mm512_set1_epi8(value); }
+			static Reg Add(Reg a, Reg b) { return _mm512_adds_epi8(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_subs_epi8(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_epi8(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_epi8(a, b); }
+			static Reg Abs(Reg a) { return _mm512_max_epi8(a, _mm512_subs_epi8(_mm512_setzero_si512(), a)); }
+		};
+
+		template<> struct Vec<AVX512, ushort> : VecAVX512Int<ushort>
+		{
+			static Reg Set1(ushort value) { return _mm512_set1_epi16((short)value); }
+			static Reg Add(Reg a, Reg b) { return _mm512_adds_epu16(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_subs_epu16(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_epu16(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_epu16(a, b); }
+			static Reg Abs(Reg a) { return a; }
+		};
+
+		template<> struct Vec<AVX512, short> : VecAVX512Int<short>
+		{
+			static Reg Set1(short value) { return _mm512_set1_epi16(value); }
+			static Reg Add(Reg a, Reg b) { return _mm512_adds_epi16(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_subs_epi16(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_epi16(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_epi16(a, b); }
+			static Reg Abs(Reg a) { return _mm512_max_epi16(a, _mm512_subs_epi16(_mm512_setzero_si512(), a)); }
+		};
+
+		template<> struct Vec<AVX512, int> : VecAVX512Int<int>
+		{
+			static Reg Set1(int value) { return _mm512_set1_epi32(value); }
+			static Reg Add(Reg a, Reg b) { return _mm512_add_epi32(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm512_sub_epi32(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm512_min_epi32(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm512_max_epi32(a, b); }
+			static Reg Abs(Reg a) { return _mm512_abs_epi32(a); }
+		};
+#pragma endregion
+
+#pragma region Conversion
+		// Cvt<ISA>ͬԪ֮ת32λͨlanesΪλ
+		// 8λ16λݶչΪint32дʱѹ
+		// doubleֻͨһ룬lohiĴʾ
+		template<class ISA> struct Cvt;
+
+		template<> struct Cvt<SSE2>
+		{
+			using I = __m128i;
+			using F = __m128;
+			using D = __m128d;
+			static constexpr size_t lanes = 4;
+
+			static I LoadI32(const uchar* ptr)
+			{
+				int v;
+				memcpy(&v, ptr, 4);
+				I zero = _mm_setzero_si128();
+				return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+			}
+			static I LoadI32(const char* ptr)
+			{
+				int v;
+				memcpy(&v, ptr, 4);
+				I x = _mm_cvtsi32_si128(v);
+				x = _mm_unpacklo_epi8(x, x);
+				return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 24);
+			}
+			static I LoadI32(const ushort* ptr)
+			{
+				return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)ptr), _mm_setzero_si128());
+			}
+			static I LoadI32(const short* ptr)
+			{
+				I x = _mm_loadl_epi64((const __m128i*)ptr);
+				return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+			}
+			static I LoadI32(const int* ptr) { return _mm_loadu_si128((const __m128i*)ptr); }
+
+			static void StoreI32(uchar* ptr, I a)
+			{
+				I x = _mm_packs_epi32(a, a);
+				int v = _mm_cvtsi128_si32(_mm_packus_epi16(x, x));
+				memcpy(ptr, &v, 4);
+			}
+			static void StoreI32(char* ptr, I a)
+			{
+				I x = _mm_packs_epi32(a, a);
+				int v = _mm_cvtsi128_si32(_mm_packs_epi16(x, x));
+				memcpy(ptr, &v, 4);
+			}
+			static void StoreI32(ushort* ptr, I a)
+			{
+				// SSE2ûpackus_epi32ƽƵзŷΧѹ
+				I bias = _mm_set1_epi32(32768);
+				I x = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(a, bias));
+				_mm_storel_epi64((__m128i*)ptr, _mm_xor_si128(x, _mm_set1_epi16(-32768)));
+			}
+			static void StoreI32(short* ptr, I a) { _mm_storel_epi64((__m128i*)ptr, _mm_packs_epi32(a, a)); }
+			static void StoreI32(int* ptr, I a) { _mm_storeu_si128((__m128i*)ptr, a); }
+
+			static F ToFloat(I a) { return _mm_cvtepi32_ps(a); }
+			static F ToFloat(D lo, D hi) { return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)); }
+			// ͽȡżint32ΧֵȽض
+			static I ToInt(F a)
+			{
+				a = _mm_min_ps(_mm_max_ps(a, _mm_set1_ps(-2147483648.f)), _mm_set1_ps(2147483520.f));
+				return _mm_cvtps_epi32(a);
+			}
+			static I ToInt(D lo, D hi)
+			{
+				D min = _mm_set1_pd(-2147483648.), max = _mm_set1_pd(2147483647.);
+				I l = _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(lo, min), max));
+				I h = _mm_cvtpd_epi32(_mm_min_pd(_mm_max_pd(hi, min), max));
+				return _mm_unpacklo_epi64(l, h);
+			}
+			static D ToDoubleLo(I a) { return _mm_cvtepi32_pd(a); }
+			static D ToDoubleHi(I a) { return _mm_cvtepi32_pd(_mm_srli_si128(a, 8)); }
+			static D ToDoubleLo(F a) { return _mm_cvtps_pd(a); }
+			static D ToDoubleHi(F a) { return _mm_cvtps_pd(_mm_movehl_ps(a, a)); }
+
+			// SSE2ûF16Cfloat16ת
+			static F LoadF32(const float16* ptr) { return _mm_setr_ps(ptr[0], ptr[1], ptr[2], ptr[3]); }
+			static F LoadF32(const bfloat16* ptr)
+			{
+				return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*)ptr)));
+			}
+			template<class Half>
+			static void StoreF32(Half* ptr, F a)
+			{
+				float v[4];
+				_mm_storeu_ps(v, a);
+				for (int i = 0; i < 4; i++) ptr[i] = v[i];
+			}
+		};
+
+		template<> struct Cvt<AVX2>
+		{
+			using I = __m256i;
+			using F = __m256;
+			using D = __m256d;
+			static constexpr size_t lanes = 8;
+
+			static I LoadI32(const uchar* ptr) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)ptr)); }
+			static I LoadI32(const char* ptr) { return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)ptr)); }
+			static I LoadI32(const ushort* ptr) { return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)ptr)); }
+			static I LoadI32(const short* ptr) { return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)ptr)); }
+			static I LoadI32(const int* ptr) { return _mm256_loadu_si256((const __m256i*)ptr); }
+
+			// pack128λֱУҪ
+			static __m128i PackS16(I a) { return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packs_epi32(a, a), 0x08)); }
+			static __m128i PackU16(I a) { return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(a, a), 0x08)); }
+
+			static void StoreI32(uchar* ptr, I a) { __m128i x = PackS16(a); _mm_storel_epi64((__m128i*)ptr, _mm_packus_epi16(x, x)); }
+			static void StoreI32(char* ptr, I a) { __m128i x = PackS16(a); _mm_storel_epi64((__m128i*)ptr, _mm_packs_epi16(x, x)); }
+			static void StoreI32(ushort* ptr, I a) { _mm_storeu_si128((__m128i*)ptr, PackU16(a)); }
+			static void StoreI32(short* ptr, I a) { _mm_storeu_si128((__m128i*)ptr, PackS16(a)); }
+			static void StoreI32(int* ptr, I a) { _mm256_storeu_si256((__m256i*)ptr, a); }
+
+			static F ToFloat(I a) { return _mm256_cvtepi32_ps(a); }
+			static F ToFloat(D lo, D hi) { return _mm256_set_m128(_mm256_cvtpd_ps(hi), _mm256_cvtpd_ps(lo)); }
+			static I ToInt(F a)
+			{
+				a = _mm256_min_ps(_mm256_max_ps(a, _mm256_set1_ps(-2147483648.f)), _mm256_set1_ps(2147483520.f));
+				return _mm256_cvtps_epi32(a);
+			}
+			static I ToInt(D lo, D hi)
+			{
+				D min = _mm256_set1_pd(-2147483648.), max = _mm256_set1_pd(2147483647.);
+				__m128i l = _mm256_cvtpd_epi32(_mm256_min_pd(_mm256_max_pd(lo, min), max));
+				__m128i h = _mm256_cvtpd_epi32(_mm256_min_pd(_mm256_max_pd(hi, min), max));
+				return _mm256_set_m128i(h, l);
+			}
+			static D ToDoubleLo(I a) { return _mm256_cvtepi32_pd(_mm256_castsi256_si128(a)); }
+			static D ToDoubleHi(I a) { return _mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)); }
+			static D ToDoubleLo(F a) { return _mm256_cvtps_pd(_mm256_castps256_ps128(a)); }
+			static D ToDoubleHi(F a) { return _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)); }
+
+			// SIMD_AVX2ҪCPU֧F16C
+			static F LoadF32(const float16* ptr) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr)); }
+			static F LoadF32(const bfloat16* ptr)
+			{
+				return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)ptr)), 16));
+			}
+			static void StoreF32(float16* ptr, F a) { _mm_storeu_si128((__m128i*)ptr, _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT)); }
+			// ͽȡżbfloat16::FromFloatһ
+			static void StoreF32(bfloat16* ptr, F a)
+			{
+				I x = _mm256_castps_si256(a), high = _mm256_srli_epi32(x, 16);
+				I r = _mm256_add_epi32(x, _mm256_add_epi32(_mm256_set1_epi32(0x7fff), _mm256_and_si256(high, _mm256_set1_epi32(1))));
+				r = _mm256_blendv_epi8(_mm256_srli_epi32(r, 16), _mm256_or_si256(high, _mm256_set1_epi32(0x40)),
+					_mm256_castps_si256(_mm256_cmp_ps(a, a, _CMP_UNORD_Q)));
+				_mm_storeu_si128((__m128i*)ptr, _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1)));
+			}
+		};
+
+		template<> struct Cvt<AVX512>
+		{
+			using I = __m512i;
+			using F = __m512;
+			using D = __m512d;
+			static constexpr size_t lanes = 16;
+
+			static I LoadI32(const uchar* ptr) { return _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)ptr)); }
+			static I LoadI32(const char* ptr) { return _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)ptr)); }
+			static I LoadI32(const ushort* ptr) { return _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)ptr)); }
+			static I LoadI32(const short* ptr) { return _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)ptr)); }
+			static I LoadI32(const int* ptr) { return _mm512_loadu_si512(ptr); }
+
+			// cvtusepi32뵱޷ҪȽضϵ0
+			static void StoreI32(uchar* ptr, I a) { _mm_storeu_si128((__m128i*)ptr, _mm512_cvtusepi32_epi8(_mm512_max_epi32(a, _mm512_setzero_si512()))); }
+			static void StoreI32(char* ptr, I a) { _mm_storeu_si128((__m128i*)ptr, _mm512_cvtsepi32_epi8(a)); }
+			static void StoreI32(ushort* ptr, I a) { _mm256_storeu_si256((__m256i*)ptr, _mm512_cvtusepi32_epi16(_mm512_max_epi32(a, _mm512_setzero_si512()))); }
+			static void StoreI32(short* ptr, I a) { _mm256_storeu_si256((__m256i*)ptr, _mm512_cvtsepi32_epi16(a)); }
+			static void StoreI32(int* ptr, I a) { _mm512_storeu_si512(ptr, a); }
+
+			static F ToFloat(I a) { return _mm512_cvtepi32_ps(a); }
+			static F ToFloat(D lo, D hi)
+			{
+				__m256i l = _mm256_castps_si256(_mm512_cvtpd_ps(lo)), h = _mm256_castps_si256(_mm512_cvtpd_ps(hi));
+				return _mm512_castsi512_ps(_mm512_inserti64x4(_mm512_castsi256_si512(l), h, 1));
+			}
+			static I ToInt(F a)
+			{
+				a = _mm512_min_ps(_mm512_max_ps(a, _mm512_set1_ps(-2147483648.f)), _mm512_set1_ps(2147483520.f));
+				return _mm512_cvtps_epi32(a);
+			}
+			static I ToInt(D lo, D hi)
+			{
+				D min = _mm512_set1_pd(-2147483648.), max = _mm512_set1_pd(2147483647.);
+				__m256i l = _mm512_cvtpd_epi32(_mm512_min_pd(_mm512_max_pd(lo, min), max));
+				__m256i h = _mm512_cvtpd_epi32(_mm512_min_pd(_mm512_max_pd(hi, min), max));
+				return _mm512_inserti64x4(_mm512_castsi256_si512(l), h, 1);
+			}
+			static D ToDoubleLo(I a) { return _mm512_cvtepi32_pd(_mm512_castsi512_si256(a)); }
+			static D ToDoubleHi(I a) { return _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(a, 1)); }
+			static D ToDoubleLo(F a) { return _mm512_cvtps_pd(_mm512_castps512_ps256(a)); }
+			static D ToDoubleHi(F a) { return _mm512_cvtps_pd(_mm256_castsi256_ps(_mm512_extracti64x4_epi64(_mm512_castps_si512(a), 1))); }
+
+			static F LoadF32(const float16* ptr) { return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)ptr)); }
+			static F LoadF32(const bfloat16* ptr)
+			{
+				return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)ptr)), 16));
+			}
+			static void StoreF32(float16* ptr, F a) { _mm256_storeu_si256((__m256i*)ptr, _mm512_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT)); }
+			static void StoreF32(bfloat16* ptr, F a)
+			{
+				I x = _mm512_castps_si512(a), high = _mm512_srli_epi32(x, 16);
+				I r = _mm512_add_epi32(x, _mm512_add_epi32(_mm512_set1_epi32(0x7fff), _mm512_and_si512(high, _mm512_set1_epi32(1))));
+				r = _mm512_mask_mov_epi32(_mm512_srli_epi32(r, 16), _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q), _mm512_or_si512(high, _mm512_set1_epi32(0x40)));
+				_mm256_storeu_si256((__m256i*)ptr, _mm512_cvtepi32_epi16(r));
+			}
+		};
+#pragma endregion
+
+#pragma region Transpose
+		// Transpose<ISA, Bytes>תһtile x tileС飬ԪشСΪBytes
+		// ֽΪλdst[j][i] = src[i][j]
+		template<class ISA, size_t Bytes> struct Transpose
+		{
+			static constexpr size_t tile = 1;
+			static void Tile(const uchar* src, size_t, uchar* dst, size_t) { memcpy(dst, src, Bytes); }
+		};
+
+		template<> struct Transpose<SSE2, 1>
+		{
+			static constexpr size_t tile = 8;
+			static void Tile(const uchar* src, size_t src_step, uchar* dst, size_t dst_step)
+			{
+				__m128i a[8];
+				for (int i = 0; i < 8; i++) a[i] = _mm_loadl_epi64((const __m128i*)(src + i * src_step));
+
+				__m128i b0 = _mm_unpacklo_epi8(a[0], a[1]), b1 = _mm_unpacklo_epi8(a[2], a[3]);
+				__m128i b2 = _mm_unpacklo_epi8(a[4], a[5]), b3 = _mm_unpacklo_epi8(a[6], a[7]);
+				__m128i c0 = _mm_unpacklo_epi16(b0, b1), c1 = _mm_unpackhi_epi16(b0, b1);
+				__m128i c2 = _mm_unpacklo_epi16(b2, b3), c3 = _mm_unpackhi_epi16(b2, b3);
+				__m128i d[4] = { _mm_unpacklo_epi32(c0, c2), _mm_unpackhi_epi32(c0, c2),
+					_mm_unpacklo_epi32(c1, c3), _mm_unpackhi_epi32(c1, c3) };
+
+				for (int j = 0; j < 4; j++)
+				{
+					_mm_storel_epi64((__m128i*)(dst + (2 * j) * dst_step), d[j]);
+					_mm_storel_epi64((__m128i*)(dst + (2 * j + 1) * dst_step), _mm_unpackhi_epi64(d[j], d[j]));
+				}
+			}
+		};
+
+		template<> struct Transpose<SSE2, 2>
+		{
+			static constexpr size_t tile = 8;
+			static void Tile(const uchar* src, size_t src_step, uchar* dst, size_t dst_step)
+			{
+				__m128i a[8];
+				for (int i = 0; i < 8; i++) a[i] = _mm_loadu_si128((const __m128i*)(src + i * src_step));
+
+				__m128i b0 = _mm_unpacklo_epi16(a[0], a[1]), b1 = _mm_unpackhi_epi16(a[0], a[1]);
+				__m128i b2 = _mm_unpacklo_epi16(a[2], a[3]), b3 = _mm_unpackhi_epi16(a[2], a[3]);
+				__m128i b4 = _mm_unpacklo_epi16(a[4], a[5]), b5 = _mm_unpackhi_epi16(a[4], a[5]);
+				__m128i b6 = _mm_unpacklo_epi16(a[6], a[7]), b7 = _mm_unpackhi_epi16(a[6], a[7]);
+				__m128i c0 = _mm_unpacklo_epi32(b0, b2), c1 = _mm_unpackhi_epi32(b0, b2);
+				__m128i c2 = _mm_unpacklo_epi32(b1, b3), c3 = _mm_unpackhi_epi32(b1, b3);
+				__m128i c4 = _mm_unpacklo_epi32(b4, b6), c5 = _mm_unpackhi_epi32(b4, b6);
+				__m128i c6 = _mm_unpacklo_epi32(b5, b7), c7 = _mm_unpackhi_epi32(b5, b7);
+
+				__m128i o[8] = { _mm_unpacklo_epi64(c0, c4), _mm_unpackhi_epi64(c0, c4),
+					_mm_unpacklo_epi64(c1, c5), _mm_unpackhi_epi64(c1, c5),
+					_mm_unpacklo_epi64(c2, c6), _mm_unpackhi_epi64(c2, c6),
+					_mm_unpacklo_epi64(c3, c7), _mm_unpackhi_epi64(c3, c7) };
+				for (int j = 0; j < 8; j++) _mm_storeu_si128((__m128i*)(dst + j * dst_step), o[j]);
+			}
+		};
+
+		template<> struct Transpose<SSE2, 4>
+		{
+			static constexpr size_t tile = 4;
+			static void Tile(const uchar* src, size_t src_step, uchar* dst, size_t dst_step)
+			{
+				__m128 r0 = _mm_loadu_ps((const float*)(src));
+				__m128 r1 = _mm_loadu_ps((const float*)(src + src_step));
+				__m128 r2 = _mm_loadu_ps((const float*)(src + 2 * src_step));
+				__m128 r3 = _mm_loadu_ps((const float*)(src + 3 * src_step));
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				_mm_storeu_ps((float*)(dst), r0);
+				_mm_storeu_ps((float*)(dst + dst_step), r1);
+				_mm_storeu_ps((float*)(dst + 2 * dst_step), r2);
+				_mm_storeu_ps((float*)(dst + 3 * dst_step), r3);
+			}
+		};
+
+		template<> struct Transpose<SSE2, 8>
+		{
+			static constexpr size_t tile = 2;
+			static void Tile(const uchar* src, size_t src_step, uchar* dst, size_t dst_step)
+			{
+				__m128d r0 = _mm_loadu_pd((const double*)(src));
+				__m128d r1 = _mm_loadu_pd((const double*)(src + src_step));
+				_mm_storeu_pd((double*)(dst), _mm_unpacklo_pd(r0, r1));
+				_mm_storeu_pd((double*)(dst + dst_step), _mm_unpackhi_pd(r0, r1));
+			}
+		};
+
+		template<> struct Transpose<AVX2, 4>
+		{
+			static constexpr size_t tile = 8;
+			static void Tile(const uchar* src, size_t src_step, uchar* dst, size_t dst_step)
+			{
+				__m256 r[8];
+				for (int i = 0; i < 8; i++) r[i] = _mm256_loadu_ps((const float*)(src + i * src_step));
+
+				__m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+				__m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+				__m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+				__m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+				__m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44), s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+				__m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44), s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+				__m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44), s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+				__m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44), s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+				__m256 o[8] = { _mm256_permute2f128_ps(s0, s4, 0x20), _mm256_permute2f128_ps(s1, s5, 0x20),
+					_mm256_permute2f128_ps(s2, s6, 0x20), _mm256_permute2f128_ps(s3, s7, 0x20),
+					_mm256_permute2f128_ps(s0, s4, 0x31), _mm256_permute2f128_ps(s1, s5, 0x31),
+					_mm256_permute2f128_ps(s2, s6, 0x31), _mm256_permute2f128_ps(s3, s7, 0x31) };
+				for (int j = 0; j < 8; j++) _mm256_storeu_ps((float*)(dst + j * dst_step), o[j]);
+			}
+		};
+
+		// 8λݺƽ֮תÿδ16
+		// pshufbÿ16ֽڵĿĳֽͨٺϲҪSSSE3ԴAVX2ʼṩ
+		template<size_t Channels>
+		struct Interleave8
+		{
+			static constexpr size_t pixels = 16;
+
+			struct Masks
+			{
+				Masks()
+				{
+					for (size_t b = 0; b < Channels; b++)
+					{
+						for (size_t c = 0; c < Channels; c++)
+						{
+							for (size_t k = 0; k < 16; k++)
+							{
+								// kͨcڽеλ
+								size_t p = k * Channels + c;
+								split[b][c][k] = (char)(p / 16 == b ? p % 16 : 0x80);
+								// ݿbĵkֽĸͨĸ
+								size_t q = b * 16 + k;
+								merge[b][c][k] = (char)(q % Channels == c ? q / Channels : 0x80);
+							}
+						}
+					}
+				}
+
+				alignas(16) char split[Channels][Channels][16];
+				alignas(16) char merge[Channels][Channels][16];
+			};
+
+			static const Masks& GetMasks()
+			{
+				static const Masks masks;
+				return masks;
+			}
+
+			// srcΪ16أdst + c * plane_stepΪͨcƽ
+			static void Split(const uchar* src, uchar* dst, size_t plane_step)
+			{
+				const Masks& masks = GetMasks();
+				__m128i block[Channels];
+				for (size_t b = 0; b < Channels; b++) block[b] = _mm_loadu_si128((const __m128i*)(src + 16 * b));
+
+				for (size_t c = 0; c < Channels; c++)
+				{
+					__m128i out = _mm_setzero_si128();
+					for (size_t b = 0; b < Channels; b++)
+						out = _mm_or_si128(out, _mm_shuffle_epi8(block[b], _mm_load_si128((const __m128i*)masks.split[b][c])));
+					_mm_storeu_si128((__m128i*)(dst + c * plane_step), out);
+				}
+			}
+
+			// Split
+			static void Merge(const uchar* src, size_t plane_step, uchar* dst)
+			{
+				const Masks& masks = GetMasks();
+				__m128i plane[Channels];
+				for (size_t c = 0; c < Channels; c++) plane[c] = _mm_loadu_si128((const __m128i*)(src + c * plane_step));
+
+				for (size_t b = 0; b < Channels; b++)
+				{
+					__m128i out = _mm_setzero_si128();
+					for (size_t c = 0; c < Channels; c++)
+						out = _mm_or_si128(out, _mm_shuffle_epi8(plane[c], _mm_load_si128((const __m128i*)masks.merge[b][c])));
+					_mm_storeu_si128((__m128i*)(dst + 16 * b), out);
+				}
+			}
+		};
+
+		// õһʵ
+		template<size_t Bytes> struct Transpose<AVX2, Bytes> : Transpose<SSE2, Bytes> {};
+		template<size_t Bytes> struct Transpose<AVX512, Bytes> : Transpose<AVX2, Bytes> {};
+#pragma endregion
+
+	} // namespace simd
+
+} // namespace chaos
@@ -0,0 +1,176 @@
+#include "core\allocator.hpp"
+#include "core\core.hpp"
+
+#include <malloc.h>
+
+namespace chaos
+{
+	static MatBlock* SystemAllocate(size_t capacity)
+	{
+		auto block = (MatBlock*)_aligned_malloc(sizeof(MatBlock) + capacity, alignof(MatBlock));
+		CHECK(nullptr != block) << "Out of memory, require " << capacity << " bytes.";
+		return block;
+	}
+
+	static void SystemDeallocate(MatBlock* block)
+	{
+		_aligned_free(block);
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const AllocatorStats& stats)
+	{
+		stream << "[allocations: " << stats.allocations << ", deallocations: " << stats.deallocations
+			<< ", hits: " << stats.pool_hits << ", misses: " << stats.pool_misses
+			<< ", hit rate: " << stats.HitRate() * 100 << "%, in use: " << stats.bytes_in_use
+			<< " bytes, cached: " << stats.bytes_cached << " bytes]";
+		return stream;
+	}
+
+#pragma region MatAllocator
+	static std::atomic<MatAllocator*> default_allocator{ nullptr };
+
+	MatAllocator* MatAllocator::GetDefault()
+	{
+		MatAllocator* allocator = default_allocator.load(std::memory_order_acquire);
+		if (nullptr != allocator) return allocator;
+
+		// ͷţ⾲̬˳ȫMatͷʱѾ
+		static PoolAllocator* pool = new PoolAllocator();
+		MatAllocator* expected = nullptr;
+		default_allocator.compare_exchange_strong(expected, pool);
+		return default_allocator.load(std::memory_order_acquire);
+	}
+
+	void MatAllocator::SetDefault(MatAllocator* allocator)
+	{
+		default_allocator.store(allocator, std::memory_order_release);
+	}
+#pragma endregion
+
+#pragma region PoolAllocator
+	PoolAllocator::PoolAllocator(size_t cache_limit) : cache_limit(cache_limit),
+		allocations(0), deallocations(0), pool_hits(0), pool_misses(0), bytes_in_use(0), bytes_cached(0)
+	{
+		free_list.resize(1 + (max_shift - min_shift) * 4);
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		Trim();
+	}
+
+	int PoolAllocator::SizeClass(size_t size, size_t& capacity)
+	{
+		if (size <= ((size_t)1 << min_shift))
+		{
+			capacity = (size_t)1 << min_shift;
+			return 0;
+		}
+		if (size > ((size_t)1 << max_shift))
+		{
+			capacity = size;
+			return -1;
+		}
+
+		// (2^msb, 2^(msb+1)]䰴1/4ּ
+		int msb = 0;
+		for (size_t n = size - 1; n > 1; n >>= 1) msb++;
+
+		size_t quarter = (size_t)1 << (msb - 2);
+		size_t mult = (size + quarter - 1) / quarter; // 5, 6, 7, 8
+		capacity = mult * quarter;
+		return 1 + (msb - min_shift) * 4 + (int)(mult - 5);
+	}
+
+	MatBlock* PoolAllocator::Allocate(size_t size, bool zero_fill)
+	{
+		size_t capacity;
+		int size_class = SizeClass(size, capacity);
+
+		MatBlock* block = nullptr;
+		if (size_class >= 0)
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			auto& list = free_list[size_class];
+			if (!list.empty())
+			{
+				block = list.back();
+				list.pop_back();
+				bytes_cached -= capacity;
+			}
+		}
+
+		if (nullptr != block)
+		{
+			pool_hits++;
+		}
+		else
+		{
+			pool_misses++;
+			block = SystemAllocate(capacity);
+		}
+
+		block->ref_cnt.store(1, std::memory_order_relaxed);
+		block->capacity = capacity;
+		block->allocator = this;
+		block->size_class = size_class;
+
+		// ֻõĲ
+		if (zero_fill) memset(block->Data(), 0, size);
+
+		allocations++;
+		bytes_in_use += capacity;
+		return block;
+	}
+
+	void PoolAllocator::Deallocate(MatBlock* block)
+	{
+		if (nullptr == block) return;
+
+		size_t capacity = block->capacity;
+		deallocations++;
+		bytes_in_use -= capacity;
+
+		if (block->size_class >= 0)
+		{
+			// жϺͼҪͬһڣ򲢷ͷŻᳬcache_limit
+			std::lock_guard<std::mutex> lock(mtx);
+			if (bytes_cached + capacity <= cache_limit)
+			{
+				free_list[block->size_class].push_back(block);
+				bytes_cached += capacity;
+				return;
+			}
+		}
+
+		SystemDeallocate(block);
+	}
+
+	AllocatorStats PoolAllocator::Stats() const
+	{
+		AllocatorStats stats;
+		stats.allocations = allocations;
+		stats.deallocations = deallocations;
+		stats.pool_hits = pool_hits;
+		stats.pool_misses = pool_misses;
+		stats.bytes_in_use = bytes_in_use;
+		stats.bytes_cached = bytes_cached;
+		return stats;
+	}
+
+	void PoolAllocator::Trim()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		for (auto& list : free_list)
+		{
+			for (auto block : list)
+			{
+				bytes_cached -= block->capacity;
+				SystemDeallocate(block);
+			}
+			list.clear();
+		}
+	}
+#pragma endregion
+
+} // namespace chaos
@@ -0,0 +1,295 @@
+#include "core\arithmetic.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+
+namespace chaos
+{
+	// 32SļӼƴз
+	static inline int WrapAdd(int a, int b) { return (int)((unsigned)a + (unsigned)b); }
+	static inline int WrapSub(int a, int b) { return (int)((unsigned)a - (unsigned)b); }
+
+	// ÿṩһ汾һ汾
+	// vectorizedΪfalseʱֻʹñ汾
+#pragma region Operators
+	template<class Type>
+	class OpAdd
+	{
+	public:
+		static constexpr bool vectorized = true;
+
+		Type operator()(Type a, Type b) const
+		{
+			if constexpr (std::is_same<Type, int>::value) return WrapAdd(a, b);
+			else if constexpr (std::is_floating_point<Type>::value) return a + b;
+			else return SaturateCast<Type>((int)a + (int)b);
+		}
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const { return V::Add(a, b); }
+
+		double scale;
+	};
+
+	template<class Type>
+	class OpSub
+	{
+	public:
+		static constexpr bool vectorized = true;
+
+		Type operator()(Type a, Type b) const
+		{
+			if constexpr (std::is_same<Type, int>::value) return WrapSub(a, b);
+			else if constexpr (std::is_floating_point<Type>::value) return a - b;
+			else return SaturateCast<Type>((int)a - (int)b);
+		}
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const { return V::Sub(a, b); }
+
+		double scale;
+	};
+
+	template<class Type>
+	class OpMul
+	{
+	public:
+		static constexpr bool vectorized = std::is_floating_point<Type>::value;
+
+		Type operator()(Type a, Type b) const
+		{
+			if constexpr (std::is_floating_point<Type>::value) return a * b * (Type)scale;
+			else return SaturateCast<Type>((double)a * b * scale);
+		}
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const
+		{
+			return V::Mul(V::Mul(a, b), V::Set1((Type)scale));
+		}
+
+		double scale;
+	};
+
+	template<class Type>
+	class OpDiv
+	{
+	public:
+		static constexpr bool vectorized = std::is_floating_point<Type>::value;
+
+		Type operator()(Type a, Type b) const
+		{
+			if constexpr (std::is_floating_point<Type>::value) return a * (Type)scale / b;
+			else return b == 0 ? 0 : SaturateCast<Type>(a * scale / b);
+		}
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const
+		{
+			return V::Div(V::Mul(a, V::Set1((Type)scale)), b);
+		}
+
+		double scale;
+	};
+
+	// scalealpha
+	template<class Type>
+	class OpScaleAdd
+	{
+	public:
+		static constexpr bool vectorized = std::is_floating_point<Type>::value;
+
+		Type operator()(Type a, Type b) const
+		{
+			if constexpr (std::is_floating_point<Type>::value) return a * (Type)scale + b;
+			else return SaturateCast<Type>(a * scale + b);
+		}
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const
+		{
+			return V::FMA(a, V::Set1((Type)scale), b);
+		}
+
+		double scale;
+	};
+
+	template<class Type>
+	class OpMin
+	{
+	public:
+		static constexpr bool vectorized = true;
+
+		Type operator()(Type a, Type b) const { return b < a ? b : a; }
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const { return V::Min(a, b); }
+
+		double scale;
+	};
+
+	template<class Type>
+	class OpMax
+	{
+	public:
+		static constexpr bool vectorized = true;
+
+		Type operator()(Type a, Type b) const { return a < b ? b : a; }
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg b) const { return V::Max(a, b); }
+
+		double scale;
+	};
+
+	// һԪ㣬ڶ
+	template<class Type>
+	class OpAbs
+	{
+	public:
+		static constexpr bool vectorized = true;
+
+		Type operator()(Type a, Type) const
+		{
+			if constexpr (std::is_unsigned<Type>::value) return a;
+			else if constexpr (std::is_same<Type, int>::value) return a < 0 ? WrapSub(0, a) : a;
+			else if constexpr (std::is_floating_point<Type>::value) return std::abs(a);
+			else return SaturateCast<Type>(std::abs((int)a));
+		}
+		template<class V>
+		typename V::Reg operator()(V, typename V::Reg a, typename V::Reg) const { return V::Abs(a); }
+
+		double scale;
+	};
+#pragma endregion
+
+#pragma region Kernels
+	template<class ISA, class Type, class Op>
+	static void BinaryRow(const Type* src1, const Type* src2, Type* dst, size_t len, const Op& op)
+	{
+		size_t i = 0;
+		if constexpr (Op::vectorized && !std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, Type>;
+			for (; i + 2 * V::lanes <= len; i += 2 * V::lanes)
+			{
+				auto a0 = V::Load(src1 + i), a1 = V::Load(src1 + i + V::lanes);
+				auto b0 = V::Load(src2 + i), b1 = V::Load(src2 + i + V::lanes);
+				V::Store(dst + i, op(V(), a0, b0));
+				V::Store(dst + i + V::lanes, op(V(), a1, b1));
+			}
+			for (; i + V::lanes <= len; i += V::lanes)
+			{
+				V::Store(dst + i, op(V(), V::Load(src1 + i), V::Load(src2 + i)));
+			}
+		}
+		for (; i < len; i++)
+		{
+			dst[i] = op(src1[i], src2[i]);
+		}
+	}
+
+	// 16λֶתΪfloat㣬ÿεĻL1Уֻһ
+	template<class ISA, class Type, class Op>
+	static void HalfBinaryRow(const Type* src1, const Type* src2, Type* dst, size_t len, const Op& op)
+	{
+		constexpr size_t block = 256;
+		float a[block], b[block];
+		for (size_t i = 0; i < len; i += block)
+		{
+			size_t n = std::min(block, len - i);
+			ToFloat(src1 + i, a, n);
+			ToFloat(src2 + i, b, n);
+			BinaryRow<ISA>((const float*)a, (const float*)b, a, n, op);
+			FromFloat(a, dst + i, n);
+		}
+	}
+
+	template<class ISA, class Type, class Op>
+	static void BinaryRows(const Mat& src1, const Mat& src2, Mat& dst, const Op& op)
+	{
+		MatRowIterator it({ &src1, &src2, &dst });
+		for (size_t row = 0; row < it.rows; row++)
+		{
+			if constexpr (IsHalf<Type>::value)
+				HalfBinaryRow<ISA>((const Type*)it.Ptr(0, row), (const Type*)it.Ptr(1, row), (Type*)it.Ptr(2, row), it.length, op);
+			else
+				BinaryRow<ISA>((const Type*)it.Ptr(0, row), (const Type*)it.Ptr(1, row), (Type*)it.Ptr(2, row), it.length, op);
+		}
+	}
+
+	// ʱָȼѡʵ
+	template<class Type, template<class> class Op>
+	static void BinaryOp(const Mat& src1, const Mat& src2, Mat& dst, double scale)
+	{
+		// 16λfloat
+		Op<typename std::conditional<IsHalf<Type>::value, float, Type>::type> op{ scale };
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			BinaryRows<simd::AVX512, Type>(src1, src2, dst, op); break;
+		case SIMD_AVX2:
+			BinaryRows<simd::AVX2, Type>(src1, src2, dst, op); break;
+		case SIMD_SSE2:
+			BinaryRows<simd::SSE2, Type>(src1, src2, dst, op); break;
+		default:
+			BinaryRows<simd::Scalar, Type>(src1, src2, dst, op); break;
+		}
+	}
+
+	template<template<class> class Op>
+	static void Arithmetic(const Mat& src1, const Mat& src2, Mat& dst, double scale)
+	{
+		CHECK(nullptr != src1.data_start && nullptr != src2.data_start) << "Empty input.";
+		CHECK(src1.size == src2.size) << "Size mismatch: " << src1.size << " vs " << src2.size << ".";
+		CHECK_EQ(src1.depth, src2.depth) << "Depth mismatch.";
+
+		dst.Create(src1.size, src1.depth, false, src1.layout);
+
+		DispatchDepth(src1.depth, [&](auto tag) { BinaryOp<typename decltype(tag)::Type, Op>(src1, src2, dst, scale); });
+	}
+#pragma endregion
+
+	void Add(const Mat& src1, const Mat& src2, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("Add");
+		Arithmetic<OpAdd>(src1, src2, dst, 1);
+	}
+
+	void Subtract(const Mat& src1, const Mat& src2, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("Subtract");
+		Arithmetic<OpSub>(src1, src2, dst, 1);
+	}
+
+	void Multiply(const Mat& src1, const Mat& src2, Mat& dst, double scale)
+	{
+		CHAOS_PROFILE_SCOPE("Multiply");
+		Arithmetic<OpMul>(src1, src2, dst, scale);
+	}
+
+	void Divide(const Mat& src1, const Mat& src2, Mat& dst, double scale)
+	{
+		CHAOS_PROFILE_SCOPE("Divide");
+		Arithmetic<OpDiv>(src1, src2, dst, scale);
+	}
+
+	void ScaleAdd(const Mat& src1, double alpha, const Mat& src2, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("ScaleAdd");
+		Arithmetic<OpScaleAdd>(src1, src2, dst, alpha);
+	}
+
+	void Min(const Mat& src1, const Mat& src2, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("Min");
+		Arithmetic<OpMin>(src1, src2, dst, 1);
+	}
+
+	void Max(const Mat& src1, const Mat& src2, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("Max");
+		Arithmetic<OpMax>(src1, src2, dst, 1);
+	}
+
+	void Abs(const Mat& src, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("Abs");
+		// ڶ㣬srcֻΪ˸öԪı
+		Arithmetic<OpAbs>(src, src, dst, 1);
+	}
+
+} // namespace chaos
@@ -0,0 +1,376 @@
+#include "core\binary_log.hpp"
+#include "core\core.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+namespace chaos
+{
+	static constexpr char binary_log_magic[8] = { 'C', 'H', 'A', 'O', 'S', 'B', 'L', 'G' };
+	static constexpr uint32_t binary_log_version = 1;
+	static constexpr size_t thread_buffer_size = 64 << 10;
+
+	// ļͷ֮ɿɣÿһֽڵıǩʼ
+	// 'S' õ㣺id, line, severity, file, format, types
+	// 'D' һ̵߳һ¼thread, bytes, ¼...
+	// ¼id, ʱ룩ַΪȼ
+	static constexpr char tag_site = 'S';
+	static constexpr char tag_data = 'D';
+
+	static std::atomic<bool> is_open{ false };
+
+	class BinaryLogSiteInfo
+	{
+	public:
+		std::string file;
+		int line;
+		LogSeverity severity;
+		std::string format;
+		std::string types;
+	};
+
+	class ThreadLogBuffer
+	{
+	public:
+		ThreadLogBuffer();
+		~ThreadLogBuffer();
+
+		std::mutex mtx; // ֻFlushʱŻ߳̾
+		std::vector<char> data;
+		size_t used = 0;
+		uint32_t thread = 0;
+	};
+
+	// ˳Ϊregistry_mtx -> ThreadLogBuffer::mtx -> file_mtx
+	class BinaryLogFile
+	{
+	public:
+		static BinaryLogFile& Get()
+		{
+			static BinaryLogFile file;
+			return file;
+		}
+
+		template<class Type>
+		void Write(const Type& value)
+		{
+			stream.write((const char*)&value, sizeof(value));
+		}
+		void WriteString(const std::string& str)
+		{
+			Write((uint32_t)str.size());
+			stream.write(str.data(), str.size());
+		}
+
+		void WriteSite(uint32_t id, const BinaryLogSiteInfo& info)
+		{
+			stream.put(tag_site);
+			Write(id);
+			Write((int32_t)info.line);
+			Write((int32_t)info.severity);
+			WriteString(info.file);
+			WriteString(info.format);
+			WriteString(info.types);
+		}
+
+		// bufferеļ¼дļʱҪbuffer
+		void WriteBuffer(ThreadLogBuffer& buffer)
+		{
+			if (0 == buffer.used) return;
+
+			std::lock_guard<std::mutex> lock(file_mtx);
+			if (stream.is_open())
+			{
+				stream.put(tag_data);
+				Write(buffer.thread);
+				Write((uint32_t)buffer.used);
+				stream.write(buffer.data.data(), buffer.used);
+			}
+			buffer.used = 0;
+		}
+
+		std::mutex registry_mtx;
+		std::vector<ThreadLogBuffer*> buffers;
+		uint32_t next_thread = 0;
+
+		std::mutex file_mtx;
+		std::ofstream stream;
+		std::vector<BinaryLogSiteInfo> sites; // iidΪi + 1
+	};
+
+	ThreadLogBuffer::ThreadLogBuffer() : data(thread_buffer_size)
+	{
+		BinaryLogFile& file = BinaryLogFile::Get();
+		std::lock_guard<std::mutex> lock(file.registry_mtx);
+		thread = file.next_thread++;
+		file.buffers.push_back(this);
+	}
+
+	ThreadLogBuffer::~ThreadLogBuffer()
+	{
+		BinaryLogFile& file = BinaryLogFile::Get();
+		std::lock_guard<std::mutex> registry_lock(file.registry_mtx);
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			file.WriteBuffer(*this);
+		}
+		file.buffers.erase(std::find(file.buffers.begin(), file.buffers.end(), this));
+	}
+
+	// ʱȹBinaryLogFile֤ļȸ̵߳Ļ
+	static ThreadLogBuffer& LocalBuffer()
+	{
+		thread_local ThreadLogBuffer buffer;
+		return buffer;
+	}
+
+	void BinaryLog::Open(const std::string& file)
+	{
+		BinaryLogFile& log = BinaryLogFile::Get();
+		Close();
+
+		std::lock_guard<std::mutex> lock(log.file_mtx);
+		log.stream.open(file, std::ios::out | std::ios::binary | std::ios::trunc);
+		CHECK(log.stream.is_open()) << "Can not open " << file;
+
+		log.stream.write(binary_log_magic, sizeof(binary_log_magic));
+		log.Write(binary_log_version);
+		log.Write((uint32_t)0);
+		// ֮ǰǼǹĵõ㲻ٵǼǣļдһ
+		for (size_t i = 0; i < log.sites.size(); i++) log.WriteSite((uint32_t)i + 1, log.sites[i]);
+
+		is_open = true;
+	}
+
+	bool BinaryLog::IsOpen()
+	{
+		return is_open.load(std::memory_order_relaxed);
+	}
+
+	void BinaryLog::Close()
+	{
+		is_open = false;
+		Flush();
+
+		BinaryLogFile& log = BinaryLogFile::Get();
+		std::lock_guard<std::mutex> lock(log.file_mtx);
+		if (log.stream.is_open()) log.stream.close();
+	}
+
+	void BinaryLog::Flush()
+	{
+		BinaryLogFile& log = BinaryLogFile::Get();
+		std::lock_guard<std::mutex> registry_lock(log.registry_mtx);
+		for (auto buffer : log.buffers)
+		{
+			std::lock_guard<std::mutex> lock(buffer->mtx);
+			log.WriteBuffer(*buffer);
+		}
+
+		std::lock_guard<std::mutex> lock(log.file_mtx);
+		if (log.stream.is_open()) log.stream.flush();
+	}
+
+	uint32_t BinaryLog::RegisterSite(BinaryLogSite& site, const char* format, const char* types)
+	{
+		BinaryLogFile& log = BinaryLogFile::Get();
+		std::lock_guard<std::mutex> lock(log.file_mtx);
+		// ߳ͬʱǼʱֻһ
+		uint32_t id = site.id.load(std::memory_order_relaxed);
+		if (0 != id) return id;
+
+		log.sites.push_back({ site.file, site.line, site.severity, format, types });
+		id = (uint32_t)log.sites.size();
+		if (log.stream.is_open()) log.WriteSite(id, log.sites.back());
+		site.id.store(id, std::memory_order_relaxed);
+		return id;
+	}
+
+	char* BinaryLog::Begin(size_t bytes)
+	{
+		ThreadLogBuffer& buffer = LocalBuffer();
+		buffer.mtx.lock();
+		if (bytes > buffer.data.size() - buffer.used)
+		{
+			BinaryLogFile::Get().WriteBuffer(buffer);
+			if (bytes > buffer.data.size()) buffer.data.resize(bytes);
+		}
+		char* ptr = buffer.data.data() + buffer.used;
+		buffer.used += bytes;
+		return ptr;
+	}
+
+	void BinaryLog::End()
+	{
+		LocalBuffer().mtx.unlock();
+	}
+
+#pragma region Decoder
+
+	// ʧʱ0
+	template<class Type>
+	static Type Read(std::istream& in)
+	{
+		Type value = Type();
+		in.read((char*)&value, sizeof(value));
+		return value;
+	}
+
+	// ļʵʶݷֶ𻵵ĳȲһηڴ
+	template<class Buffer>
+	static void ReadBytes(std::istream& in, Buffer& buff, size_t bytes)
+	{
+		constexpr size_t step = 1 << 20;
+		buff.clear();
+		while (in && buff.size() < bytes)
+		{
+			size_t used = buff.size();
+			size_t n = std::min(step, bytes - used);
+			buff.resize(used + n);
+			in.read(&buff[used], n);
+		}
+	}
+
+	static std::string ReadString(std::istream& in)
+	{
+		std::string str;
+		ReadBytes(in, str, Read<uint32_t>(in));
+		return str;
+	}
+
+	// Ӽ¼ȡһʽBinaryLog::Printһ£ʣµݲʱfalse
+	template<class Type>
+	static bool DecodeArg(const char*& ptr, const char* end, std::ostream& stream)
+	{
+		Type value;
+		if ((size_t)(end - ptr) < sizeof(value)) return false;
+		memcpy(&value, ptr, sizeof(value));
+		ptr += sizeof(value);
+		stream << value;
+		return true;
+	}
+
+	static bool DecodeString(const char*& ptr, const char* end, std::ostream& stream)
+	{
+		uint32_t len;
+		if ((size_t)(end - ptr) < sizeof(len)) return false;
+		memcpy(&len, ptr, sizeof(len));
+		if ((size_t)(end - ptr) - sizeof(len) < len) return false;
+		stream.write(ptr + sizeof(len), len);
+		ptr += sizeof(len) + len;
+		return true;
+	}
+
+	void DecodeBinaryLog(std::istream& in, std::ostream& out)
+	{
+		static const char* severity_text[] = { "INFO", "WARNING", "ERROR", "FATAL" };
+
+		char magic[sizeof(binary_log_magic)];
+		in.read(magic, sizeof(magic));
+		CHECK(in && 0 == memcmp(magic, binary_log_magic, sizeof(magic))) << "Not a binary log.";
+		CHECK_EQ(Read<uint32_t>(in), binary_log_version) << "Unsupported binary log version.";
+		Read<uint32_t>(in);
+
+		class Record
+		{
+		public:
+			int64_t time;
+			std::string text;
+		};
+
+		std::map<uint32_t, BinaryLogSiteInfo> sites;
+		std::vector<Record> records;
+		std::vector<char> chunk;
+		for (int tag = in.get(); tag != EOF; tag = in.get())
+		{
+			if (tag == tag_site)
+			{
+				uint32_t id = Read<uint32_t>(in);
+				BinaryLogSiteInfo& info = sites[id];
+				info.line = Read<int32_t>(in);
+				int32_t severity = Read<int32_t>(in);
+				info.file = ReadString(in);
+				info.format = ReadString(in);
+				info.types = ReadString(in);
+				if (!in) break;
+				CHECK(INFO <= severity && severity <= FATAL) << "Invalid severity " << severity << " of log site " << id;
+				info.severity = (LogSeverity)severity;
+				continue;
+			}
+
+			CHECK_EQ(tag, tag_data) << "Corrupted binary log.";
+			Read<uint32_t>(in); // ̱߳
+			ReadBytes(in, chunk, Read<uint32_t>(in));
+			if (!in) break; // 쳣˳ʱһܲ
+
+			// ¼еĳȶļend飬ļ¼֮ݶ
+			const char* ptr = chunk.data();
+			const char* end = ptr + chunk.size();
+			bool complete = true;
+			while (complete && ptr < end)
+			{
+				uint32_t id;
+				int64_t time;
+				if ((size_t)(end - ptr) < sizeof(id) + sizeof(time)) break;
+				memcpy(&id, ptr, sizeof(id));
+				memcpy(&time, ptr + sizeof(id), sizeof(time));
+				ptr += sizeof(id) + sizeof(time);
+
+				auto it = sites.find(id);
+				CHECK(it != sites.end()) << "Unknown log site " << id;
+				const BinaryLogSiteInfo& info = it->second;
+
+				// ǰ׺LogMessageһ£ʱ侫ȷ΢
+				std::stringstream stream;
+				time_t second = (time_t)(time / 1000000000);
+				tm tm_time;
+				localtime_s(&tm_time, &second);
+				char stamp[32];
+				strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_time);
+				stream << "[" << severity_text[info.severity] << " " << stamp << "."
+					<< std::setfill('0') << std::setw(6) << (time / 1000) % 1000000 << std::setfill(' ')
+					<< " " << info.file << ":" << info.line << "] ";
+
+				const char* format = info.format.c_str();
+				for (char type : info.types)
+				{
+					if (!complete) break;
+					const char* pos = strstr(format, "{}");
+					if (nullptr == pos) stream << format << " ";
+					else stream.write(format, pos - format);
+					format = nullptr == pos ? format + strlen(format) : pos + 2;
+
+					switch (type)
+					{
+					case 'b': complete = DecodeArg<bool>(ptr, end, stream); break;
+					case 'c': complete = DecodeArg<char>(ptr, end, stream); break;
+					case 'i': complete = DecodeArg<int32_t>(ptr, end, stream); break;
+					case 'I': complete = DecodeArg<int64_t>(ptr, end, stream); break;
+					case 'u': complete = DecodeArg<uint32_t>(ptr, end, stream); break;
+					case 'U': complete = DecodeArg<uint64_t>(ptr, end, stream); break;
+					case 'f': complete = DecodeArg<float>(ptr, end, stream); break;
+					case 'd': complete = DecodeArg<double>(ptr, end, stream); break;
+					case 's': complete = DecodeString(ptr, end, stream); break;
+					default:
+						LOG(FATAL) << "Unknown argument type " << type;
+					}
+				}
+				stream << format;
+
+				if (complete) records.push_back({ time, stream.str() });
+			}
+		}
+
+		// ̵߳ļ¼ǳдģʱ
+		std::stable_sort(records.begin(), records.end(), [](const Record& a, const Record& b) { return a.time < b.time; });
+		for (auto& record : records) out << record.text << "\n";
+	}
+
+#pragma endregion
+
+} // namespace chaos
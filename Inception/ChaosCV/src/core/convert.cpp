@@ -0,0 +1,289 @@
+#include "core\mat.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+
+namespace chaos
+{
+	// 8λ16λ16F16BF֮תfloat㹻ȷ漰32S64Fʱdouble
+	template<class Src, class Dst>
+	using ConvertWork = typename std::conditional<
+		std::is_same<Src, double>::value || std::is_same<Dst, double>::value ||
+		std::is_same<Src, int>::value || std::is_same<Dst, int>::value, double, float>::type;
+
+#pragma region Load & Store
+	// һδCvt<ISA>::lanesԪ
+	template<class ISA, class Src>
+	static typename simd::Cvt<ISA>::F LoadAsFloat(const Src* ptr)
+	{
+		using C = simd::Cvt<ISA>;
+		if constexpr (std::is_same<Src, float>::value) return simd::Vec<ISA, float>::Load(ptr);
+		else if constexpr (IsHalf<Src>::value) return C::LoadF32(ptr);
+		else return C::ToFloat(C::LoadI32(ptr));
+	}
+
+	template<class ISA, class Dst>
+	static void StoreFloat(Dst* ptr, typename simd::Cvt<ISA>::F a)
+	{
+		using C = simd::Cvt<ISA>;
+		if constexpr (std::is_same<Dst, float>::value) simd::Vec<ISA, float>::Store(ptr, a);
+		else if constexpr (IsHalf<Dst>::value) C::StoreF32(ptr, a);
+		else C::StoreI32(ptr, C::ToInt(a));
+	}
+
+	template<class ISA, class Src>
+	static void LoadAsDouble(const Src* ptr, typename simd::Cvt<ISA>::D& lo, typename simd::Cvt<ISA>::D& hi)
+	{
+		using C = simd::Cvt<ISA>;
+		using VD = simd::Vec<ISA, double>;
+		if constexpr (std::is_same<Src, double>::value)
+		{
+			lo = VD::Load(ptr);
+			hi = VD::Load(ptr + VD::lanes);
+		}
+		else if constexpr (std::is_same<Src, float>::value || IsHalf<Src>::value)
+		{
+			auto a = LoadAsFloat<ISA>(ptr);
+			lo = C::ToDoubleLo(a);
+			hi = C::ToDoubleHi(a);
+		}
+		else
+		{
+			auto a = C::LoadI32(ptr);
+			lo = C::ToDoubleLo(a);
+			hi = C::ToDoubleHi(a);
+		}
+	}
+
+	template<class ISA, class Dst>
+	static void StoreDouble(Dst* ptr, typename simd::Cvt<ISA>::D lo, typename simd::Cvt<ISA>::D hi)
+	{
+		using C = simd::Cvt<ISA>;
+		using VD = simd::Vec<ISA, double>;
+		if constexpr (std::is_same<Dst, double>::value)
+		{
+			VD::Store(ptr, lo);
+			VD::Store(ptr + VD::lanes, hi);
+		}
+		else if constexpr (std::is_same<Dst, float>::value || IsHalf<Dst>::value)
+		{
+			StoreFloat<ISA>(ptr, C::ToFloat(lo, hi));
+		}
+		else
+		{
+			C::StoreI32(ptr, C::ToInt(lo, hi));
+		}
+	}
+#pragma endregion
+
+#pragma region Kernels
+	// dst[i] = saturate(src[i] * alpha + beta)
+	template<class ISA, class Src, class Dst>
+	static void ConvertRow(const Src* src, Dst* dst, size_t len, double alpha, double beta)
+	{
+		using Work = ConvertWork<Src, Dst>;
+		const Work a = (Work)alpha, b = (Work)beta;
+
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			constexpr size_t lanes = simd::Cvt<ISA>::lanes;
+			if constexpr (std::is_same<Work, float>::value)
+			{
+				using VF = simd::Vec<ISA, float>;
+				auto va = VF::Set1(a), vb = VF::Set1(b);
+				for (; i + lanes <= len; i += lanes)
+				{
+					StoreFloat<ISA>(dst + i, VF::FMA(LoadAsFloat<ISA>(src + i), va, vb));
+				}
+			}
+			else
+			{
+				using VD = simd::Vec<ISA, double>;
+				auto va = VD::Set1(a), vb = VD::Set1(b);
+				for (; i + lanes <= len; i += lanes)
+				{
+					typename VD::Reg lo, hi;
+					LoadAsDouble<ISA>(src + i, lo, hi);
+					StoreDouble<ISA>(dst + i, VD::FMA(lo, va, vb), VD::FMA(hi, va, vb));
+				}
+			}
+		}
+		for (; i < len; i++)
+		{
+			dst[i] = SaturateCast<Dst>((Work)src[i] * a + b);
+		}
+	}
+
+	// ͨNHWCʱİͨתalphabetaperiodԪظ
+	// periodͨȵĹڵĲֱӼ
+	template<class ISA, class Src, class Dst>
+	static void ConvertRowInterleaved(const Src* src, Dst* dst, size_t len,
+		const ConvertWork<Src, Dst>* alpha, const ConvertWork<Src, Dst>* beta, size_t period)
+	{
+		using Work = ConvertWork<Src, Dst>;
+
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			constexpr size_t lanes = simd::Cvt<ISA>::lanes;
+			if constexpr (std::is_same<Work, float>::value)
+			{
+				using VF = simd::Vec<ISA, float>;
+				for (size_t j = 0; i + lanes <= len; i += lanes, j = (j + lanes) % period)
+				{
+					StoreFloat<ISA>(dst + i, VF::FMA(LoadAsFloat<ISA>(src + i), VF::Load(alpha + j), VF::Load(beta + j)));
+				}
+			}
+			else
+			{
+				using VD = simd::Vec<ISA, double>;
+				for (size_t j = 0; i + lanes <= len; i += lanes, j = (j + lanes) % period)
+				{
+					typename VD::Reg lo, hi;
+					LoadAsDouble<ISA>(src + i, lo, hi);
+					lo = VD::FMA(lo, VD::Load(alpha + j), VD::Load(beta + j));
+					hi = VD::FMA(hi, VD::Load(alpha + j + VD::lanes), VD::Load(beta + j + VD::lanes));
+					StoreDouble<ISA>(dst + i, lo, hi);
+				}
+			}
+		}
+		for (; i < len; i++)
+		{
+			dst[i] = SaturateCast<Dst>((Work)src[i] * alpha[i % period] + beta[i % period]);
+		}
+	}
+
+	// alphabetaĳΪ1ʱͨãͨȡ
+	template<class ISA, class Src, class Dst>
+	static void ConvertRows(const Mat& src, Mat& dst, const std::vector<double>& alpha, const std::vector<double>& beta)
+	{
+		using Work = ConvertWork<Src, Dst>;
+
+		bool per_channel = alpha.size() > 1;
+		MatRowIterator it({ &src, &dst }, !per_channel);
+		if (per_channel && it.channel_inner)
+		{
+			// ÿжͨ0ʼչ16صĳ
+			size_t period = src.size[1] * 16;
+			std::vector<Work> a(period), b(period);
+			for (size_t i = 0; i < period; i++)
+			{
+				a[i] = (Work)alpha[i % src.size[1]];
+				b[i] = (Work)beta[i % src.size[1]];
+			}
+			for (size_t row = 0; row < it.rows; row++)
+			{
+				ConvertRowInterleaved<ISA>((const Src*)it.Ptr(0, row), (Dst*)it.Ptr(1, row), it.length, a.data(), b.data(), period);
+			}
+			return;
+		}
+
+		for (size_t row = 0; row < it.rows; row++)
+		{
+			size_t c = per_channel ? it.Channel(row) : 0;
+			ConvertRow<ISA>((const Src*)it.Ptr(0, row), (Dst*)it.Ptr(1, row), it.length, alpha[c], beta[c]);
+		}
+	}
+
+	// float16λ֮䲻ʱֱӳת
+	template<class Src, class Dst>
+	static void ConvertHalf(const Mat& src, Mat& dst)
+	{
+		MatRowIterator it({ &src, &dst });
+		for (size_t row = 0; row < it.rows; row++)
+		{
+			if constexpr (IsHalf<Src>::value) ToFloat((const Src*)it.Ptr(0, row), (float*)it.Ptr(1, row), it.length);
+			else FromFloat((const float*)it.Ptr(0, row), (Dst*)it.Ptr(1, row), it.length);
+		}
+	}
+
+	template<class Src, class Dst>
+	static void Convert(const Mat& src, Mat& dst, const std::vector<double>& alpha, const std::vector<double>& beta)
+	{
+		if constexpr ((IsHalf<Src>::value && std::is_same<Dst, float>::value) || (std::is_same<Src, float>::value && IsHalf<Dst>::value))
+		{
+			bool identity = true;
+			for (size_t c = 0; c < alpha.size(); c++) identity = identity && alpha[c] == 1 && beta[c] == 0;
+			if (identity)
+			{
+				ConvertHalf<Src, Dst>(src, dst);
+				return;
+			}
+		}
+
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			ConvertRows<simd::AVX512, Src, Dst>(src, dst, alpha, beta); break;
+		case SIMD_AVX2:
+			ConvertRows<simd::AVX2, Src, Dst>(src, dst, alpha, beta); break;
+		case SIMD_SSE2:
+			ConvertRows<simd::SSE2, Src, Dst>(src, dst, alpha, beta); break;
+		default:
+			ConvertRows<simd::Scalar, Src, Dst>(src, dst, alpha, beta); break;
+		}
+	}
+
+	static void ConvertScale(const Mat& src, Mat& dst, MatDepth depth, const std::vector<double>& alpha, const std::vector<double>& beta)
+	{
+		CHECK(nullptr != src.data_start) << "Empty input.";
+		if (DEPTH_UNKNOW == depth) depth = src.depth;
+
+		// ԭתͬȣдʱMat
+		if (&src == &dst && depth != src.depth)
+		{
+			Mat tmp;
+			ConvertScale(src, tmp, depth, alpha, beta);
+			dst = std::move(tmp);
+			return;
+		}
+
+		dst.Create(src.size, depth, false, src.layout);
+
+		bool identity = true;
+		for (size_t c = 0; c < alpha.size(); c++) identity = identity && alpha[c] == 1 && beta[c] == 0;
+		// ͬҲʱֻǿ
+		if (identity && src.depth == depth)
+		{
+			src.CopyTo(dst);
+			return;
+		}
+
+		DispatchDepth(src.depth, [&](auto src_tag) {
+			DispatchDepth(depth, [&](auto dst_tag) {
+				Convert<typename decltype(src_tag)::Type, typename decltype(dst_tag)::Type>(src, dst, alpha, beta);
+			});
+		});
+	}
+#pragma endregion
+
+	void Mat::ConvertTo(Mat& dst, const MatDepth depth, double alpha, double beta) const
+	{
+		CHAOS_PROFILE_SCOPE("ConvertTo");
+		ConvertScale(*this, dst, depth, { alpha }, { beta });
+	}
+
+	void Mat::ConvertTo(Mat& dst, const MatDepth depth, const std::vector<double>& mean,
+		const std::vector<double>& stddev, double alpha) const
+	{
+		CHAOS_PROFILE_SCOPE("ConvertTo");
+		size_t channels = size[1];
+		CHECK(mean.size() == 1 || mean.size() == channels) << "Mean must have 1 or " << channels << " elements.";
+		CHECK(stddev.size() == 1 || stddev.size() == channels) << "Stddev must have 1 or " << channels << " elements.";
+
+		// (src * alpha - mean) / stddev = src * (alpha / stddev) + (-mean / stddev)
+		size_t n = std::max(mean.size(), stddev.size());
+		std::vector<double> scale(n), shift(n);
+		for (size_t c = 0; c < n; c++)
+		{
+			double m = mean[mean.size() == 1 ? 0 : c];
+			double s = stddev[stddev.size() == 1 ? 0 : c];
+			CHECK_NE(s, 0) << "Stddev of channel " << c << " is zero.";
+			scale[c] = alpha / s;
+			shift[c] = -m / s;
+		}
+		ConvertScale(*this, dst, depth, scale, shift);
+	}
+
+} // namespace chaos
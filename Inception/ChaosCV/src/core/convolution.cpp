@@ -0,0 +1,544 @@
+#include "core\convolution.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+#include "core\parallel.hpp"
+
+namespace chaos
+{
+	// ͨʱ3x3Winogradͨʱ任Ŀռ̫
+	static constexpr size_t winograd_min_channels = 16;
+
+	// ĸߴ磬ǽеNCHW
+	struct ConvShape
+	{
+		size_t num, in_chs, height, width;
+		size_t out_chs, kernel_h, kernel_w;
+		size_t out_h, out_w;
+		size_t groups, group_in, group_out;
+		int stride_h, stride_w, pad_h, pad_w, dilation_h, dilation_w;
+	};
+
+	// еNCHWֱӰָʣ򿽱һ
+	static Mat Dense(const Mat& mtx)
+	{
+		if (LAYOUT_NCHW == mtx.layout && mtx.IsContinuous()) return mtx;
+
+		Mat tmp;
+		mtx.ToLayout(tmp, LAYOUT_NCHW);
+		return tmp;
+	}
+
+	// һݰװrows x colsľ󣬲
+	template<class Type>
+	static Mat Wrap(const Type* data, size_t rows, size_t cols)
+	{
+		return Mat(MatSize(1, 1, rows, cols), DataDepth<Type>::depth, (void*)data);
+	}
+
+	// ÿһӦͨbias֮GEMMbeta = 1ۼ
+	static void FillBias(float* dst, const float* bias, size_t chs, size_t plane)
+	{
+		for (size_t c = 0; c < chs; c++) std::fill(dst + c * plane, dst + (c + 1) * plane, bias[c]);
+	}
+
+	// ̳ͨ߳л֣㹻ʱΪβ
+	static void ForEachImage(size_t num, const std::function<void(size_t)>& body)
+	{
+		bool batch_parallel = num > 1 && num >= GetNumThreads();
+		ParallelFor(Range(0, num), batch_parallel ? 1 : num, [&](const Range& range) {
+			for (size_t n = range.begin; n < range.end; n++) body(n);
+		});
+	}
+
+#pragma region 1x1
+	// strideΪ1û1x1ÿweight(Cout x Cin) * src(Cin x HW)
+	static void Conv1x1(const ConvShape& s, const float* src, const float* weight, const float* bias, float* dst)
+	{
+		size_t plane = s.height * s.width;
+		ForEachImage(s.num, [&](size_t n) {
+			const float* in = src + n * s.in_chs * plane;
+			float* out = dst + n * s.out_chs * plane;
+			if (bias) FillBias(out, bias, s.out_chs, plane);
+
+			for (size_t g = 0; g < s.groups; g++)
+			{
+				Mat C = Wrap(out + g * s.group_out * plane, s.group_out, plane);
+				Gemm(Wrap(weight + g * s.group_out * s.group_in, s.group_out, s.group_in),
+					Wrap(in + g * s.group_in * plane, s.group_in, plane), C, 1, bias ? 1 : 0);
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region im2col
+	// colÿһжӦ(c, ky, kx)ÿһжӦһλã߽λΪpad
+	template<class Type>
+	static void Im2col(const ConvShape& s, const Type* src, Type* col, Type pad = 0)
+	{
+		size_t kernel = s.kernel_h * s.kernel_w;
+		size_t out_plane = s.out_h * s.out_w;
+
+		ParallelFor(Range(0, s.group_in * kernel), 8, [&](const Range& range) {
+			for (size_t r = range.begin; r < range.end; r++)
+			{
+				size_t c = r / kernel;
+				int ky = (int)(r % kernel / s.kernel_w);
+				int kx = (int)(r % s.kernel_w);
+				const Type* in = src + c * s.height * s.width;
+				Type* dst = col + r * out_plane;
+
+				int off_x = kx * s.dilation_w - s.pad_w;
+				for (size_t oy = 0; oy < s.out_h; oy++, dst += s.out_w)
+				{
+					int iy = (int)oy * s.stride_h - s.pad_h + ky * s.dilation_h;
+					if (iy < 0 || iy >= (int)s.height)
+					{
+						std::fill(dst, dst + s.out_w, pad);
+						continue;
+					}
+
+					const Type* row = in + iy * s.width;
+					if (1 == s.stride_w)
+					{
+						// мĲο
+						int from = std::min((int)s.out_w, std::max(0, -off_x));
+						int to = std::max(from, std::min((int)s.out_w, (int)s.width - off_x));
+						std::fill(dst, dst + from, pad);
+						memcpy(dst + from, row + from + off_x, (to - from) * sizeof(Type));
+						std::fill(dst + to, dst + s.out_w, pad);
+					}
+					else
+					{
+						for (size_t ox = 0; ox < s.out_w; ox++)
+						{
+							int ix = (int)ox * s.stride_w + off_x;
+							dst[ox] = 0 <= ix && ix < (int)s.width ? row[ix] : pad;
+						}
+					}
+				}
+			}
+		});
+	}
+
+	static void ConvIm2col(const ConvShape& s, const float* src, const float* weight, const float* bias, float* dst)
+	{
+		size_t in_plane = s.height * s.width;
+		size_t out_plane = s.out_h * s.out_w;
+		size_t rows = s.group_in * s.kernel_h * s.kernel_w;
+
+		ForEachImage(s.num, [&](size_t n) {
+			const float* in = src + n * s.in_chs * in_plane;
+			float* out = dst + n * s.out_chs * out_plane;
+			if (bias) FillBias(out, bias, s.out_chs, out_plane);
+
+			std::vector<float> col(rows * out_plane);
+			for (size_t g = 0; g < s.groups; g++)
+			{
+				Im2col(s, in + g * s.group_in * in_plane, col.data());
+
+				Mat C = Wrap(out + g * s.group_out * out_plane, s.group_out, out_plane);
+				Gemm(Wrap(weight + g * s.group_out * rows, s.group_out, rows), Wrap(col.data(), rows, out_plane), C, 1, bias ? 1 : 0);
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region Depthwise
+	// dst[i] += k * src[i]
+	template<class ISA>
+	static void AxpyRow(float* dst, const float* src, float k, size_t len)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, float>;
+			auto vk = V::Set1(k);
+			for (; i + V::lanes <= len; i += V::lanes)
+			{
+				V::Store(dst + i, V::FMA(V::Load(src + i), vk, V::Load(dst + i)));
+			}
+		}
+		for (; i < len; i++) dst[i] += k * src[i];
+	}
+
+	// ÿͨۼӣÿԪضһһγ˼
+	template<class ISA>
+	static void ConvDepthwise(const ConvShape& s, const float* src, const float* weight, const float* bias, float* dst)
+	{
+		size_t kernel = s.kernel_h * s.kernel_w;
+		ParallelFor(Range(0, s.num * s.out_chs), 1, [&](const Range& range) {
+			for (size_t slice = range.begin; slice < range.end; slice++)
+			{
+				size_t c = slice % s.out_chs;
+				const float* in = src + slice * s.height * s.width;
+				const float* w = weight + c * kernel;
+				float* out = dst + slice * s.out_h * s.out_w;
+
+				for (size_t oy = 0; oy < s.out_h; oy++)
+				{
+					float* row = out + oy * s.out_w;
+					std::fill(row, row + s.out_w, bias ? bias[c] : 0.f);
+
+					for (size_t ky = 0; ky < s.kernel_h; ky++)
+					{
+						int iy = (int)oy * s.stride_h - s.pad_h + (int)ky * s.dilation_h;
+						if (iy < 0 || iy >= (int)s.height) continue;
+						const float* line = in + iy * s.width;
+
+						for (size_t kx = 0; kx < s.kernel_w; kx++)
+						{
+							float k = w[ky * s.kernel_w + kx];
+							int off = (int)kx * s.dilation_w - s.pad_w;
+							// ox * stride + off[0, W)ڵ
+							int from = off < 0 ? (-off + s.stride_w - 1) / s.stride_w : 0;
+							int to = (int)s.width - off <= 0 ? 0 : std::min((int)s.out_w, ((int)s.width - 1 - off) / s.stride_w + 1);
+							if (from >= to) continue;
+
+							if (1 == s.stride_w)
+							{
+								AxpyRow<ISA>(row + from, line + from + off, k, to - from);
+							}
+							else
+							{
+								for (int ox = from; ox < to; ox++) row[ox] += k * line[ox * s.stride_w + off];
+							}
+						}
+					}
+				}
+			}
+		});
+	}
+#pragma endregion
+
+#pragma region Winograd
+	// F(2x2, 3x3)U = G g G^TV = B^T d BY = A^T [U . V] A
+	// Ԫس16λϷֱCout x CinCin x tilesľˣGEMM
+	static void WinogradWeight(const float* g, float* U, size_t stride)
+	{
+		float t[4][3];
+		for (int j = 0; j < 3; j++)
+		{
+			t[0][j] = g[j];
+			t[1][j] = (g[j] + g[3 + j] + g[6 + j]) * 0.5f;
+			t[2][j] = (g[j] - g[3 + j] + g[6 + j]) * 0.5f;
+			t[3][j] = g[6 + j];
+		}
+		for (int i = 0; i < 4; i++)
+		{
+			U[(i * 4 + 0) * stride] = t[i][0];
+			U[(i * 4 + 1) * stride] = (t[i][0] + t[i][1] + t[i][2]) * 0.5f;
+			U[(i * 4 + 2) * stride] = (t[i][0] - t[i][1] + t[i][2]) * 0.5f;
+			U[(i * 4 + 3) * stride] = t[i][2];
+		}
+	}
+
+	static void WinogradInput(const float d[4][4], float* V, size_t stride)
+	{
+		float t[4][4];
+		for (int j = 0; j < 4; j++)
+		{
+			t[0][j] = d[0][j] - d[2][j];
+			t[1][j] = d[1][j] + d[2][j];
+			t[2][j] = d[2][j] - d[1][j];
+			t[3][j] = d[1][j] - d[3][j];
+		}
+		for (int i = 0; i < 4; i++)
+		{
+			V[(i * 4 + 0) * stride] = t[i][0] - t[i][2];
+			V[(i * 4 + 1) * stride] = t[i][1] + t[i][2];
+			V[(i * 4 + 2) * stride] = t[i][2] - t[i][1];
+			V[(i * 4 + 3) * stride] = t[i][1] - t[i][3];
+		}
+	}
+
+	static void WinogradOutput(const float* M, size_t stride, float y[2][2])
+	{
+		float t[2][4];
+		for (int j = 0; j < 4; j++)
+		{
+			float m0 = M[(0 + j) * stride], m1 = M[(4 + j) * stride], m2 = M[(8 + j) * stride], m3 = M[(12 + j) * stride];
+			t[0][j] = m0 + m1 + m2;
+			t[1][j] = m1 - m2 - m3;
+		}
+		for (int i = 0; i < 2; i++)
+		{
+			y[i][0] = t[i][0] + t[i][1] + t[i][2];
+			y[i][1] = t[i][1] - t[i][2] - t[i][3];
+		}
+	}
+
+	static void ConvWinograd(const ConvShape& s, const float* src, const float* weight, const float* bias, float* dst)
+	{
+		size_t tiles_h = (s.out_h + 1) / 2;
+		size_t tiles_w = (s.out_w + 1) / 2;
+		size_t tiles = tiles_h * tiles_w;
+		size_t in_plane = s.height * s.width;
+		size_t out_plane = s.out_h * s.out_w;
+
+		// U: 16 x Cout x Cin
+		std::vector<float> U(16 * s.out_chs * s.in_chs);
+		size_t u_stride = s.out_chs * s.in_chs;
+		ParallelFor(Range(0, u_stride), 64, [&](const Range& range) {
+			for (size_t i = range.begin; i < range.end; i++) WinogradWeight(weight + i * 9, U.data() + i, u_stride);
+		});
+		Mat u(MatSize(16, 1, s.out_chs, s.in_chs), DEPTH_32F, U.data());
+
+		ForEachImage(s.num, [&](size_t n) {
+			const float* in = src + n * s.in_chs * in_plane;
+			float* out = dst + n * s.out_chs * out_plane;
+
+			// V: 16 x Cin x tiles
+			std::vector<float> V(16 * s.in_chs * tiles);
+			size_t v_stride = s.in_chs * tiles;
+			ParallelFor(Range(0, s.in_chs), 1, [&](const Range& range) {
+				for (size_t c = range.begin; c < range.end; c++)
+				{
+					const float* plane = in + c * in_plane;
+					for (size_t t = 0; t < tiles; t++)
+					{
+						int y0 = (int)(t / tiles_w) * 2 - s.pad_h;
+						int x0 = (int)(t % tiles_w) * 2 - s.pad_w;
+						float d[4][4];
+						for (int i = 0; i < 4; i++)
+						{
+							int iy = y0 + i;
+							for (int j = 0; j < 4; j++)
+							{
+								int ix = x0 + j;
+								d[i][j] = 0 <= iy && iy < (int)s.height && 0 <= ix && ix < (int)s.width ? plane[iy * s.width + ix] : 0;
+							}
+						}
+						WinogradInput(d, V.data() + c * tiles + t, v_stride);
+					}
+				}
+			});
+
+			// M: 16 x Cout x tiles
+			Mat m;
+			Gemm(u, Mat(MatSize(16, 1, s.in_chs, tiles), DEPTH_32F, V.data()), m);
+
+			const float* M = (const float*)m.data_start;
+			size_t m_stride = s.out_chs * tiles;
+			ParallelFor(Range(0, s.out_chs), 1, [&](const Range& range) {
+				for (size_t c = range.begin; c < range.end; c++)
+				{
+					float b = bias ? bias[c] : 0;
+					float* plane = out + c * out_plane;
+					for (size_t t = 0; t < tiles; t++)
+					{
+						size_t oy = t / tiles_w * 2;
+						size_t ox = t % tiles_w * 2;
+						float y[2][2];
+						WinogradOutput(M + c * tiles + t, m_stride, y);
+						for (size_t i = 0; i < 2 && oy + i < s.out_h; i++)
+							for (size_t j = 0; j < 2 && ox + j < s.out_w; j++)
+								plane[(oy + i) * s.out_w + ox + j] = y[i][j] + b;
+					}
+				}
+			});
+		});
+	}
+#pragma endregion
+
+#pragma region Int8
+	// ͨout = acc * scale[c] + shift[c]
+	// acc = sum(x * w)srczero_point -zx * sum(w) biasһshift
+	static void ConvInt8(const ConvShape& s, const char* src, const char* weight, const std::vector<float>& scale,
+		const std::vector<float>& shift, char pad, float* dst)
+	{
+		size_t in_plane = s.height * s.width;
+		size_t out_plane = s.out_h * s.out_w;
+		size_t rows = s.group_in * s.kernel_h * s.kernel_w;
+		bool direct = 1 == s.kernel_h && 1 == s.kernel_w && 1 == s.stride_h && 1 == s.stride_w && 0 == s.pad_h && 0 == s.pad_w;
+
+		ForEachImage(s.num, [&](size_t n) {
+			const char* in = src + n * s.in_chs * in_plane;
+			float* out = dst + n * s.out_chs * out_plane;
+
+			std::vector<char> col(direct ? 0 : rows * out_plane);
+			Mat acc;
+			for (size_t g = 0; g < s.groups; g++)
+			{
+				// strideΪ1û1x1ֱGEMM
+				const char* B = in + g * s.group_in * in_plane;
+				if (!direct)
+				{
+					Im2col(s, B, col.data(), pad);
+					B = col.data();
+				}
+				GemmInt8(Wrap(weight + g * s.group_out * rows, s.group_out, rows), Wrap(B, rows, out_plane), acc);
+
+				// ÿһֱͨͨͨд
+				size_t c0 = g * s.group_out;
+				std::vector<float> a(scale.begin() + c0, scale.begin() + c0 + s.group_out);
+				std::vector<float> b(shift.begin() + c0, shift.begin() + c0 + s.group_out);
+				Mat plane(MatSize(1, s.group_out, 1, out_plane), DEPTH_32F, out + c0 * out_plane);
+				Dequantize(acc.Reshape(MatSize(1, s.group_out, 1, out_plane)), plane, a, b, 1);
+			}
+		});
+	}
+#pragma endregion
+
+	static ConvShape MakeShape(const Mat& src, const Mat& weight, const ConvParam& param)
+	{
+		CHECK(param.stride.width > 0 && param.stride.height > 0) << "Stride must be positive.";
+		CHECK(param.dilation.width > 0 && param.dilation.height > 0) << "Dilation must be positive.";
+		CHECK_GT(param.groups, 0) << "Groups must be positive.";
+
+		ConvShape s;
+		s.num = src.size[0];
+		s.in_chs = src.size[1];
+		s.height = src.size[2];
+		s.width = src.size[3];
+		s.out_chs = weight.size[0];
+		s.kernel_h = weight.size[2];
+		s.kernel_w = weight.size[3];
+		s.groups = param.groups;
+		s.stride_h = param.stride.height;
+		s.stride_w = param.stride.width;
+		s.pad_h = param.pad.height;
+		s.pad_w = param.pad.width;
+		s.dilation_h = param.dilation.height;
+		s.dilation_w = param.dilation.width;
+
+		CHECK(0 == s.in_chs % s.groups && 0 == s.out_chs % s.groups) << "Channels must be divisible by groups.";
+		s.group_in = s.in_chs / s.groups;
+		s.group_out = s.out_chs / s.groups;
+		CHECK_EQ(weight.size[1], s.group_in) << "Weight must be " << s.out_chs << "x" << s.group_in << "xKHxKW.";
+
+		int extent_h = (int)s.height + 2 * s.pad_h - s.dilation_h * ((int)s.kernel_h - 1) - 1;
+		int extent_w = (int)s.width + 2 * s.pad_w - s.dilation_w * ((int)s.kernel_w - 1) - 1;
+		CHECK(extent_h >= 0 && extent_w >= 0) << "Kernel is larger than the padded input.";
+		s.out_h = extent_h / s.stride_h + 1;
+		s.out_w = extent_w / s.stride_w + 1;
+		return s;
+	}
+
+	void Conv2D(const Mat& src, const Mat& weight, const Mat& bias, Mat& dst, const ConvParam& param)
+	{
+		CHAOS_PROFILE_SCOPE("Conv2D");
+		CHECK(nullptr != src.data_start && nullptr != weight.data_start) << "Empty input.";
+		CHECK(DEPTH_32F == src.depth && DEPTH_32F == weight.depth) << "Conv2D only supports DEPTH_32F.";
+		ConvShape s = MakeShape(src, weight, param);
+
+		Mat in = Dense(src);
+		Mat w = Dense(weight);
+		Mat b;
+		if (nullptr != bias.data_start)
+		{
+			CHECK(DEPTH_32F == bias.depth && bias.size[0] * bias.size[1] * bias.size[2] * bias.size[3] == s.out_chs)
+				<< "Bias must have " << s.out_chs << " elements of DEPTH_32F.";
+			b = Dense(bias);
+		}
+
+		// ͬһMatʱдʱMat
+		Mat out;
+		MatSize size(s.num, s.out_chs, s.out_h, s.out_w);
+		bool alias = &dst == &src || &dst == &weight || &dst == &bias;
+		if (!alias && size == dst.size && DEPTH_32F == dst.depth && LAYOUT_NCHW == dst.layout && dst.IsContinuous()) out = dst;
+		else out.Create(size, DEPTH_32F, false);
+
+		const float* in_ptr = (const float*)in.data_start;
+		const float* w_ptr = (const float*)w.data_start;
+		const float* b_ptr = nullptr != b.data_start ? (const float*)b.data_start : nullptr;
+		float* out_ptr = (float*)out.data_start;
+
+		bool unit = 1 == s.stride_h && 1 == s.stride_w && 1 == s.dilation_h && 1 == s.dilation_w;
+		if (1 == s.kernel_h && 1 == s.kernel_w && unit && 0 == s.pad_h && 0 == s.pad_w)
+		{
+			Conv1x1(s, in_ptr, w_ptr, b_ptr, out_ptr);
+		}
+		else if (s.groups == s.in_chs && s.groups == s.out_chs)
+		{
+			switch (GetSimdLevel())
+			{
+			case SIMD_AVX512:
+				ConvDepthwise<simd::AVX512>(s, in_ptr, w_ptr, b_ptr, out_ptr); break;
+			case SIMD_AVX2:
+				ConvDepthwise<simd::AVX2>(s, in_ptr, w_ptr, b_ptr, out_ptr); break;
+			case SIMD_SSE2:
+				ConvDepthwise<simd::SSE2>(s, in_ptr, w_ptr, b_ptr, out_ptr); break;
+			default:
+				ConvDepthwise<simd::Scalar>(s, in_ptr, w_ptr, b_ptr, out_ptr); break;
+			}
+		}
+		else if (3 == s.kernel_h && 3 == s.kernel_w && unit && 1 == s.groups &&
+			s.in_chs >= winograd_min_channels && s.out_chs >= winograd_min_channels)
+		{
+			ConvWinograd(s, in_ptr, w_ptr, b_ptr, out_ptr);
+		}
+		else
+		{
+			ConvIm2col(s, in_ptr, w_ptr, b_ptr, out_ptr);
+		}
+
+		// dst״ȷROINHWCʱдԭݣֱӹ
+		if (out.data_start != dst.data_start)
+		{
+			if (!alias && size == dst.size && DEPTH_32F == dst.depth) out.CopyTo(dst);
+			else dst = out;
+		}
+	}
+
+	void Conv2DInt8(const QMat& src, const QMat& weight, const Mat& bias, Mat& dst, const ConvParam& param)
+	{
+		CHAOS_PROFILE_SCOPE("Conv2DInt8");
+		CHECK(nullptr != src.data_start && nullptr != weight.data_start) << "Empty input.";
+		CHECK(DEPTH_8S == src.depth && DEPTH_8S == weight.depth) << "Conv2DInt8 only supports DEPTH_8S.";
+		CHECK(!src.param.PerChannel() && 1 == src.param.scale.size()) << "Input must be quantized per tensor.";
+		CHECK(weight.param.IsSymmetric()) << "Weight must be quantized symmetrically.";
+		CHECK(!weight.param.PerChannel() || 0 == weight.param.axis) << "Weight must be quantized per tensor or per output channel.";
+		ConvShape s = MakeShape(src, weight, param);
+		size_t scales = weight.param.PerChannel() ? s.out_chs : 1;
+		CHECK(weight.param.scale.size() == scales) << "Weight must have " << scales << " scales, got " << weight.param << ".";
+
+		Mat in = Dense(src);
+		Mat w = Dense(weight);
+		const float* b_ptr = nullptr;
+		Mat b;
+		if (nullptr != bias.data_start)
+		{
+			CHECK(DEPTH_32F == bias.depth && bias.size[0] * bias.size[1] * bias.size[2] * bias.size[3] == s.out_chs)
+				<< "Bias must have " << s.out_chs << " elements of DEPTH_32F.";
+			b = Dense(bias);
+			b_ptr = (const float*)b.data_start;
+		}
+
+		// ÿͨķdoublescaleСʱתΪfloat
+		size_t rows = s.group_in * s.kernel_h * s.kernel_w;
+		const char* w_ptr = (const char*)w.data_start;
+		int zero_point = src.param.zero_point[0];
+		std::vector<float> scale(s.out_chs), shift(s.out_chs);
+		for (size_t c = 0; c < s.out_chs; c++)
+		{
+			long long sum = 0;
+			for (size_t k = 0; k < rows; k++) sum += w_ptr[c * rows + k];
+			double sc = (double)src.param.scale[0] * weight.param.scale[weight.param.PerChannel() ? c : 0];
+			scale[c] = (float)sc;
+			shift[c] = (float)((b_ptr ? b_ptr[c] : 0) - sc * zero_point * sum);
+		}
+
+		Mat out;
+		MatSize size(s.num, s.out_chs, s.out_h, s.out_w);
+		bool alias = &dst == &src || &dst == &weight || &dst == &bias;
+		if (!alias && size == dst.size && DEPTH_32F == dst.depth && LAYOUT_NCHW == dst.layout && dst.IsContinuous()) out = dst;
+		else out.Create(size, DEPTH_32F, false);
+
+		ConvInt8(s, (const char*)in.data_start, w_ptr, scale, shift, (char)zero_point, (float*)out.data_start);
+
+		if (out.data_start != dst.data_start)
+		{
+			if (!alias && size == dst.size && DEPTH_32F == dst.depth) out.CopyTo(dst);
+			else dst = out;
+		}
+	}
+
+	void Conv2DInt8(const QMat& src, const QMat& weight, const Mat& bias, QMat& dst, const QuantParam& out_param, const ConvParam& param)
+	{
+		Mat out;
+		Conv2DInt8(src, weight, bias, out, param);
+		Quantize(out, dst, out_param);
+	}
+
+} // namespace chaos
@@ -0,0 +1,82 @@
+#include "core\cpu.hpp"
+
+#include <atomic>
+#include <intrin.h>
+#include <immintrin.h>
+
+namespace chaos
+{
+	class CpuInfo
+	{
+	public:
+		CpuInfo()
+		{
+			int info[4] = { 0 };
+			__cpuid(info, 0);
+			int max_leaf = info[0];
+
+			__cpuid(info, 1);
+			features[CPU_SSE2] = (info[3] >> 26) & 1;
+			features[CPU_SSE41] = (info[2] >> 19) & 1;
+			features[CPU_FMA3] = (info[2] >> 12) & 1;
+
+			// ҪϵͳYMM/ZMMĴ״̬
+			bool os_xsave = (info[2] >> 27) & 1;
+			bool avx = (info[2] >> 28) & 1;
+			unsigned long long xcr0 = os_xsave ? _xgetbv(0) : 0;
+			bool os_avx = (xcr0 & 0x06) == 0x06;
+			bool os_avx512 = (xcr0 & 0xe6) == 0xe6;
+
+			features[CPU_AVX] = avx && os_avx;
+			features[CPU_FMA3] = features[CPU_FMA3] && os_avx;
+			features[CPU_F16C] = os_avx && ((info[2] >> 29) & 1);
+
+			if (max_leaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+				features[CPU_AVX2] = os_avx && ((info[1] >> 5) & 1);
+				features[CPU_AVX512F] = os_avx512 && ((info[1] >> 16) & 1);
+				features[CPU_AVX512DQ] = os_avx512 && ((info[1] >> 17) & 1);
+				features[CPU_AVX512BW] = os_avx512 && ((info[1] >> 30) & 1);
+				features[CPU_AVX512VNNI] = os_avx512 && ((info[2] >> 11) & 1);
+			}
+
+			if (features[CPU_AVX512F] && features[CPU_AVX512BW])
+				level = SIMD_AVX512;
+			else if (features[CPU_AVX2] && features[CPU_FMA3] && features[CPU_F16C])
+				level = SIMD_AVX2;
+			else if (features[CPU_SSE2])
+				level = SIMD_SSE2;
+		}
+
+		static const CpuInfo& Get()
+		{
+			static CpuInfo info;
+			return info;
+		}
+
+		bool features[CPU_FEATURE_COUNT] = { false };
+		SimdLevel level = SIMD_NONE;
+	};
+
+	static std::atomic<int> simd_limit{ SIMD_AVX512 };
+
+	bool CheckHardwareSupport(CpuFeature feature)
+	{
+		if (feature < 0 || feature >= CPU_FEATURE_COUNT) return false;
+		return CpuInfo::Get().features[feature];
+	}
+
+	SimdLevel GetSimdLevel()
+	{
+		int level = CpuInfo::Get().level;
+		int limit = simd_limit.load(std::memory_order_relaxed);
+		return (SimdLevel)(level < limit ? level : limit);
+	}
+
+	void SetSimdLevel(SimdLevel level)
+	{
+		simd_limit.store(level, std::memory_order_relaxed);
+	}
+
+} // namespace chaos
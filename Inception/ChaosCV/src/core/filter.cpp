@@ -0,0 +1,520 @@
+#include "core\filter.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+#include "core\parallel.hpp"
+
+#include <cmath>
+
+namespace chaos
+{
+	// ÿһƽôУ֮ظȡ˸ - 1
+	static constexpr int filter_strip = 64;
+	// ˲Ĵڲʱˮƽֱ
+	static constexpr int box_direct_width = 8;
+
+	// ߽λӳ䵽[0, len)BORDER_CONSTANTʱ-1
+	static int BorderIndex(int p, int len, BorderType border)
+	{
+		if (0 <= p && p < len) return p;
+
+		switch (border)
+		{
+		case BORDER_REPLICATE:
+			return p < 0 ? 0 : len - 1;
+		case BORDER_REFLECT:
+		case BORDER_REFLECT_101:
+		{
+			if (1 == len) return 0;
+			int delta = BORDER_REFLECT_101 == border ? 1 : 0;
+			// ˱ͼʱҪ
+			while (p < 0 || p >= len)
+			{
+				p = p < 0 ? -p - 1 + delta : 2 * len - p - 1 - delta;
+			}
+			return p;
+		}
+		case BORDER_WRAP:
+			p %= len;
+			return p < 0 ? p + len : p;
+		default:
+			return -1;
+		}
+	}
+
+#pragma region Row IO
+	// һвתΪWorkstrideΪԪصļNHWCʱΪͨ
+	template<class ISA, class Src, class Work>
+	static void LoadRow(const uchar* ptr, size_t stride, size_t len, Work* dst)
+	{
+		const Src* src = (const Src*)ptr;
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value && std::is_same<Work, float>::value && !std::is_same<Src, double>::value)
+		{
+			using C = simd::Cvt<ISA>;
+			using V = simd::Vec<ISA, float>;
+			if (1 == stride)
+			{
+				for (; i + C::lanes <= len; i += C::lanes)
+				{
+					if constexpr (std::is_same<Src, float>::value) V::Store(dst + i, V::Load(src + i));
+					else V::Store(dst + i, C::ToFloat(C::LoadI32(src + i)));
+				}
+			}
+		}
+		for (; i < len; i++) dst[i] = (Work)src[i * stride];
+	}
+
+	template<class ISA, class Work, class Dst>
+	static void StoreRow(const Work* src, uchar* ptr, size_t stride, size_t len)
+	{
+		Dst* dst = (Dst*)ptr;
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value && std::is_same<Work, float>::value && !std::is_same<Dst, double>::value)
+		{
+			using C = simd::Cvt<ISA>;
+			using V = simd::Vec<ISA, float>;
+			if (1 == stride)
+			{
+				for (; i + C::lanes <= len; i += C::lanes)
+				{
+					if constexpr (std::is_same<Dst, float>::value) V::Store(dst + i, V::Load(src + i));
+					else C::StoreI32(dst + i, C::ToInt(V::Load(src + i)));
+				}
+			}
+		}
+		for (; i < len; i++) dst[i * stride] = SaturateCast<Dst>(src[i]);
+	}
+
+	// ждһƽ棬ʱ߽ģʽչ
+	template<class ISA_, class Work_>
+	class FilterRows
+	{
+	public:
+		using ISA = ISA_;
+		using Work = Work_;
+		using Load = void(*)(const uchar*, size_t, size_t, Work*);
+		using Store = void(*)(const Work*, uchar*, size_t, size_t);
+
+		FilterRows(const Mat& src, Mat& dst, BorderType border, int left, int right)
+			: width((int)src.size[3]), height((int)src.size[2]), left(left), right(right), src(src), dst(dst), border(border)
+		{
+			DispatchDepth(src.depth, [&](auto tag) {
+				using Src = typename decltype(tag)::Type;
+				if constexpr (IsHalf<Src>::value) LOG(FATAL) << "Filters do not support DEPTH_16F and DEPTH_16BF.";
+				else load = LoadRow<ISA, Src, Work>;
+			});
+			DispatchDepth(dst.depth, [&](auto tag) {
+				using Dst = typename decltype(tag)::Type;
+				if constexpr (IsHalf<Dst>::value) LOG(FATAL) << "Filters do not support DEPTH_16F and DEPTH_16BF.";
+				else store = StoreRow<ISA, Work, Dst>;
+			});
+		}
+
+		// yУԽ磩bufĳΪleft + width + right
+		void Read(size_t slice, int y, Work* buf) const
+		{
+			int row = BorderIndex(y, height, border);
+			if (row < 0)
+			{
+				std::fill(buf, buf + left + width + right, (Work)0);
+				return;
+			}
+
+			load(RowPtr(src, slice, row), src.step[3], width, buf + left);
+			for (int x = 0; x < left; x++)
+			{
+				int idx = BorderIndex(x - left, width, border);
+				buf[x] = idx < 0 ? 0 : buf[left + idx];
+			}
+			for (int x = 0; x < right; x++)
+			{
+				int idx = BorderIndex(width + x, width, border);
+				buf[left + width + x] = idx < 0 ? 0 : buf[left + idx];
+			}
+		}
+
+		void Write(size_t slice, int y, const Work* buf) const
+		{
+			store(buf, RowPtr(dst, slice, y), dst.step[3], width);
+		}
+
+		int width;
+		int height;
+		int left;
+		int right;
+
+	private:
+		static uchar* RowPtr(const Mat& mtx, size_t slice, int y)
+		{
+			size_t offset = (slice / mtx.size[1]) * mtx.step[0] + (slice % mtx.size[1]) * mtx.step[1] + y * mtx.step[2];
+			return mtx.data_start + offset * ElemSize(mtx.depth);
+		}
+
+		const Mat& src;
+		Mat& dst;
+		BorderType border;
+		Load load;
+		Store store;
+	};
+#pragma endregion
+
+#pragma region Kernels
+	// dst += src * k
+	template<class ISA, class Work>
+	static void Axpy(Work* dst, const Work* src, Work k, size_t len)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, Work>;
+			auto vk = V::Set1(k);
+			for (; i + V::lanes <= len; i += V::lanes)
+			{
+				V::Store(dst + i, V::FMA(V::Load(src + i), vk, V::Load(dst + i)));
+			}
+		}
+		for (; i < len; i++) dst[i] += src[i] * k;
+	}
+
+	// dst += add - sub
+	template<class ISA, class Work>
+	static void AddSub(Work* dst, const Work* add, const Work* sub, size_t len)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, Work>;
+			for (; i + V::lanes <= len; i += V::lanes)
+			{
+				V::Store(dst + i, V::Add(V::Load(dst + i), V::Sub(V::Load(add + i), V::Load(sub + i))));
+			}
+		}
+		for (; i < len; i++) dst[i] += add[i] - sub[i];
+	}
+
+	// dst = src * k
+	template<class ISA, class Work>
+	static void Scale(Work* dst, const Work* src, Work k, size_t len)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, Work>;
+			auto vk = V::Set1(k);
+			for (; i + V::lanes <= len; i += V::lanes) V::Store(dst + i, V::Mul(V::Load(src + i), vk));
+		}
+		for (; i < len; i++) dst[i] = src[i] * k;
+	}
+
+	// λyзy mod countλãyǸ
+	template<class Work>
+	class RingRows
+	{
+	public:
+		RingRows(int count, size_t len) : count(count), len(len), data(count * len) {}
+
+		Work* operator[](int y) { return data.data() + ((y % count + count) % count) * len; }
+
+	private:
+		int count;
+		size_t len;
+		std::vector<Work> data;
+	};
+#pragma endregion
+
+#pragma region Strips
+	// ά˸չ룬ÿĺԪضһһγ˼
+	template<class ISA, class Work>
+	static void Filter2DStrip(const FilterRows<ISA, Work>& rows, const std::vector<Work>& kernel, int kh, int kw,
+		size_t slice, int y0, int y1)
+	{
+		int ay = kh / 2;
+		size_t width = rows.width;
+		RingRows<Work> ring(kh, width + kw - 1);
+		std::vector<Work> out(width);
+
+		for (int y = y0 - ay; y < y0 - ay + kh - 1; y++) rows.Read(slice, y, ring[y]);
+		for (int y = y0; y < y1; y++)
+		{
+			int last = y - ay + kh - 1;
+			rows.Read(slice, last, ring[last]);
+
+			std::fill(out.begin(), out.end(), (Work)0);
+			for (int i = 0; i < kh; i++)
+			{
+				const Work* line = ring[y - ay + i];
+				for (int j = 0; j < kw; j++)
+				{
+					Work k = kernel[i * kw + j];
+					if (0 != k) Axpy<ISA>(out.data(), line + j, k, width);
+				}
+			}
+			rows.Write(slice, y, out.data());
+		}
+	}
+
+	// ɷÿжˮƽ˲ٷ뻺ǻиеļȨ
+	template<class ISA, class Work>
+	static void SepFilterStrip(const FilterRows<ISA, Work>& rows, const std::vector<Work>& kx, const std::vector<Work>& ky,
+		size_t slice, int y0, int y1)
+	{
+		int kh = (int)ky.size(), kw = (int)kx.size();
+		int ay = kh / 2;
+		size_t width = rows.width;
+		RingRows<Work> ring(kh, width);
+		std::vector<Work> line(width + kw - 1), out(width);
+
+		auto horizontal = [&](int y) {
+			rows.Read(slice, y, line.data());
+			Work* dst = ring[y];
+			std::fill(dst, dst + width, (Work)0);
+			for (int j = 0; j < kw; j++)
+			{
+				if (0 != kx[j]) Axpy<ISA>(dst, line.data() + j, kx[j], width);
+			}
+		};
+
+		for (int y = y0 - ay; y < y0 - ay + kh - 1; y++) horizontal(y);
+		for (int y = y0; y < y1; y++)
+		{
+			horizontal(y - ay + kh - 1);
+
+			std::fill(out.begin(), out.end(), (Work)0);
+			for (int i = 0; i < kh; i++)
+			{
+				if (0 != ky[i]) Axpy<ISA>(out.data(), ring[y - ay + i], ky[i], width);
+			}
+			rows.Write(slice, y, out.data());
+		}
+	}
+
+	// ˲ˮƽûֱͣάкͣÿֻ½һвȥƳһ
+	template<class ISA, class Work>
+	static void BoxFilterStrip(const FilterRows<ISA, Work>& rows, int kh, int kw, Work scale, size_t slice, int y0, int y1)
+	{
+		int ay = kh / 2;
+		size_t width = rows.width;
+		// һУʱƳлûб
+		RingRows<Work> ring(kh + 1, width);
+		std::vector<Work> line(width + kw - 1), sum(width, (Work)0), out(width);
+
+		// խĴֱӰƽƺļӣĴû
+		// Ͱһзֳ4Σ4ִ
+		size_t seg = (width + 3) / 4;
+		auto horizontal = [&](int y) {
+			rows.Read(slice, y, line.data());
+			Work* dst = ring[y];
+			const Work* src = line.data();
+
+			if (kw <= box_direct_width || 3 * seg >= width)
+			{
+				std::copy(src, src + width, dst);
+				for (int j = 1; j < kw; j++) Axpy<ISA>(dst, src + j, (Work)1, width);
+				return;
+			}
+
+			const Work *p0 = src, *p1 = src + seg, *p2 = src + 2 * seg, *p3 = src + 3 * seg;
+			Work *d0 = dst, *d1 = dst + seg, *d2 = dst + 2 * seg, *d3 = dst + 3 * seg;
+			Work s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+			for (int j = 0; j < kw; j++)
+			{
+				s0 += p0[j];
+				s1 += p1[j];
+				s2 += p2[j];
+				s3 += p3[j];
+			}
+			d0[0] = s0;
+			d1[0] = s1;
+			d2[0] = s2;
+			d3[0] = s3;
+
+			// һοܶһЩ
+			size_t last = width - 3 * seg;
+			size_t x = 1;
+			for (; x < last; x++)
+			{
+				s0 += p0[x + kw - 1] - p0[x - 1]; d0[x] = s0;
+				s1 += p1[x + kw - 1] - p1[x - 1]; d1[x] = s1;
+				s2 += p2[x + kw - 1] - p2[x - 1]; d2[x] = s2;
+				s3 += p3[x + kw - 1] - p3[x - 1]; d3[x] = s3;
+			}
+			for (; x < seg; x++)
+			{
+				s0 += p0[x + kw - 1] - p0[x - 1]; d0[x] = s0;
+				s1 += p1[x + kw - 1] - p1[x - 1]; d1[x] = s1;
+				s2 += p2[x + kw - 1] - p2[x - 1]; d2[x] = s2;
+			}
+		};
+
+		for (int y = y0 - ay; y < y0 - ay + kh; y++)
+		{
+			horizontal(y);
+			Axpy<ISA>(sum.data(), ring[y], (Work)1, width);
+		}
+		for (int y = y0; y < y1; y++)
+		{
+			if (y > y0)
+			{
+				int last = y - ay + kh - 1;
+				horizontal(last);
+				AddSub<ISA>(sum.data(), ring[last], ring[last - kh], width);
+			}
+			Scale<ISA>(out.data(), sum.data(), scale, width);
+			rows.Write(slice, y, out.data());
+		}
+	}
+#pragma endregion
+
+	// ָͼ㾫ѡʵ֣funcǽǩķlambda
+	template<class Func>
+	static void DispatchFilter(bool use_double, Func func)
+	{
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			use_double ? func(simd::AVX512(), double()) : func(simd::AVX512(), float()); break;
+		case SIMD_AVX2:
+			use_double ? func(simd::AVX2(), double()) : func(simd::AVX2(), float()); break;
+		case SIMD_SSE2:
+			use_double ? func(simd::SSE2(), double()) : func(simd::SSE2(), float()); break;
+		default:
+			use_double ? func(simd::Scalar(), double()) : func(simd::Scalar(), float()); break;
+		}
+	}
+
+	// ÿƽгн̳߳
+	// make(rows)ȷͺһΣصstrip(slice, y0, y1)еһΣmakeת
+	template<class MakeStrip>
+	static void FilterPlanes(const Mat& src, Mat& dst, MatDepth depth, BorderType border, int kw, const MakeStrip& make)
+	{
+		CHECK(nullptr != src.data_start) << "Empty input.";
+		if (DEPTH_UNKNOW == depth) depth = src.depth;
+
+		// صʱдʱMat
+		if (nullptr != dst.data_start && dst.data_start < src.data_end && src.data_start < dst.data_end)
+		{
+			Mat tmp;
+			FilterPlanes(src, tmp, depth, border, kw, make);
+			if (dst.size == src.size && dst.depth == depth) tmp.CopyTo(dst);
+			else dst = std::move(tmp);
+			return;
+		}
+
+		dst.Create(src.size, depth, false, src.layout);
+
+		// 8λ16λfloat㣬漰32S64Fʱdouble
+		bool use_double = DEPTH_32S == src.depth || DEPTH_64F == src.depth || DEPTH_32S == depth || DEPTH_64F == depth;
+		DispatchFilter(use_double, [&](auto isa, auto work) {
+			using ISA = decltype(isa);
+			using Work = decltype(work);
+
+			FilterRows<ISA, Work> rows(src, dst, border, kw / 2, kw - 1 - kw / 2);
+			auto strip = make(rows);
+			ParallelForTiles(src, Size((int)src.size[3], filter_strip), [&](size_t slice, const Rect& roi) {
+				strip(slice, roi.tl.y, roi.br.y);
+			});
+		});
+	}
+
+	// Ѿ˵һƽ水չ
+	static std::vector<double> KernelValues(const Mat& kernel, size_t& rows, size_t& cols)
+	{
+		CHECK(nullptr != kernel.data_start) << "Empty kernel.";
+		CHECK(1 == kernel.size[0] && 1 == kernel.size[1]) << "Kernel must have a single plane.";
+
+		Mat k;
+		kernel.ConvertTo(k, DEPTH_64F);
+		rows = k.size[2];
+		cols = k.size[3];
+
+		std::vector<double> values;
+		for (size_t r = 0; r < rows; r++)
+			for (size_t c = 0; c < cols; c++)
+				values.push_back(*k.GetPtr<double>(0, 0, r, c));
+		return values;
+	}
+
+	template<class Work>
+	static std::vector<Work> Cast(const std::vector<double>& values)
+	{
+		return std::vector<Work>(values.begin(), values.end());
+	}
+
+	void Filter2D(const Mat& src, Mat& dst, const Mat& kernel, MatDepth depth, BorderType border)
+	{
+		CHAOS_PROFILE_SCOPE("Filter2D");
+		size_t kh, kw;
+		std::vector<double> values = KernelValues(kernel, kh, kw);
+
+		FilterPlanes(src, dst, depth, border, (int)kw, [&](const auto& rows) {
+			using Work = typename std::decay<decltype(rows)>::type::Work;
+			return [&, k = Cast<Work>(values)](size_t slice, int y0, int y1) {
+				Filter2DStrip(rows, k, (int)kh, (int)kw, slice, y0, y1);
+			};
+		});
+	}
+
+	void SepFilter2D(const Mat& src, Mat& dst, const Mat& kernel_x, const Mat& kernel_y, MatDepth depth, BorderType border)
+	{
+		CHAOS_PROFILE_SCOPE("SepFilter2D");
+		size_t kh, kw;
+		std::vector<double> kx = KernelValues(kernel_x, kh, kw);
+		std::vector<double> ky = KernelValues(kernel_y, kh, kw);
+
+		FilterPlanes(src, dst, depth, border, (int)kx.size(), [&](const auto& rows) {
+			using Work = typename std::decay<decltype(rows)>::type::Work;
+			return [&, x = Cast<Work>(kx), y = Cast<Work>(ky)](size_t slice, int y0, int y1) {
+				SepFilterStrip(rows, x, y, slice, y0, y1);
+			};
+		});
+	}
+
+	// һάĸ˹ˣΪ1
+	static Mat GaussianKernel(int ksize, double sigma)
+	{
+		Mat kernel(MatSize(1, 1, 1, ksize), DEPTH_64F);
+		double* data = kernel.GetPtr<double>(0, 0, 0, 0);
+		double center = (ksize - 1) * 0.5, sum = 0;
+		for (int i = 0; i < ksize; i++)
+		{
+			data[i] = std::exp(-(i - center) * (i - center) / (2 * sigma * sigma));
+			sum += data[i];
+		}
+		for (int i = 0; i < ksize; i++) data[i] /= sum;
+		return kernel;
+	}
+
+	void GaussianBlur(const Mat& src, Mat& dst, Size ksize, double sigma_x, double sigma_y, BorderType border)
+	{
+		CHAOS_PROFILE_SCOPE("GaussianBlur");
+		if (sigma_y <= 0) sigma_y = sigma_x;
+
+		// ûָСʱ3 sigma8λ4 sigma
+		double radius = DEPTH_8U == src.depth ? 3 : 4;
+		if (ksize.width <= 0 && sigma_x > 0) ksize.width = (int)std::round(sigma_x * radius * 2 + 1) | 1;
+		if (ksize.height <= 0 && sigma_y > 0) ksize.height = (int)std::round(sigma_y * radius * 2 + 1) | 1;
+		CHECK(ksize.width > 0 && ksize.height > 0 && 1 == ksize.width % 2 && 1 == ksize.height % 2)
+			<< "Kernel size must be positive and odd, got " << ksize.width << "x" << ksize.height << ".";
+
+		if (sigma_x <= 0) sigma_x = 0.3 * ((ksize.width - 1) * 0.5 - 1) + 0.8;
+		if (sigma_y <= 0) sigma_y = 0.3 * ((ksize.height - 1) * 0.5 - 1) + 0.8;
+
+		SepFilter2D(src, dst, GaussianKernel(ksize.width, sigma_x), GaussianKernel(ksize.height, sigma_y), DEPTH_UNKNOW, border);
+	}
+
+	void BoxFilter(const Mat& src, Mat& dst, Size ksize, bool normalize, MatDepth depth, BorderType border)
+	{
+		CHAOS_PROFILE_SCOPE("BoxFilter");
+		CHECK(ksize.width > 0 && ksize.height > 0) << "Kernel size must be positive.";
+		double scale = normalize ? 1.0 / ((double)ksize.width * ksize.height) : 1.0;
+
+		FilterPlanes(src, dst, depth, border, ksize.width, [&](const auto& rows) {
+			using Work = typename std::decay<decltype(rows)>::type::Work;
+			return [&](size_t slice, int y0, int y1) {
+				BoxFilterStrip(rows, ksize.height, ksize.width, (Work)scale, slice, y0, y1);
+			};
+		});
+	}
+
+} // namespace chaos
@@ -0,0 +1,696 @@
+#include "core\gemm.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+#include "core\parallel.hpp"
+
+namespace chaos
+{
+	// BLISķʽֿ飺Bkc x ncL3Amc x kcL2
+	// ΢ںÿμCmr x nr飬ۼȫڼĴ
+	static constexpr size_t gemm_kc = 256;
+	static constexpr size_t gemm_mc = 96;
+	static constexpr size_t gemm_nc = 4096;
+
+	// һƽ棬rscsкеĲλԪ
+	template<class Type>
+	struct GemmMatrix
+	{
+		Type* data;
+		size_t rs;
+		size_t cs;
+
+		Type& operator()(size_t row, size_t col) const { return data[row * rs + col * cs]; }
+	};
+
+#pragma region Kernels
+	// c[mr x nr] = alpha * a * b + beta * caСbдbetaΪ0ʱȡc
+	template<class ISA, class Type>
+	struct GemmKernel
+	{
+		using V = simd::Vec<ISA, Type>;
+		static constexpr size_t mr = 6;
+		static constexpr size_t nr = 2 * V::lanes;
+
+		static void Run(size_t kc, const Type* a, const Type* b, Type* c, size_t ldc, Type alpha, Type beta)
+		{
+			// ۼչ֤ȫڼĴ
+			auto c00 = V::Set1(0), c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00;
+			auto c30 = c00, c31 = c00, c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+			for (size_t k = 0; k < kc; k++, a += mr, b += nr)
+			{
+				auto b0 = V::Load(b);
+				auto b1 = V::Load(b + V::lanes);
+				auto ai = V::Set1(a[0]);
+				c00 = V::FMA(ai, b0, c00); c01 = V::FMA(ai, b1, c01);
+				ai = V::Set1(a[1]);
+				c10 = V::FMA(ai, b0, c10); c11 = V::FMA(ai, b1, c11);
+				ai = V::Set1(a[2]);
+				c20 = V::FMA(ai, b0, c20); c21 = V::FMA(ai, b1, c21);
+				ai = V::Set1(a[3]);
+				c30 = V::FMA(ai, b0, c30); c31 = V::FMA(ai, b1, c31);
+				ai = V::Set1(a[4]);
+				c40 = V::FMA(ai, b0, c40); c41 = V::FMA(ai, b1, c41);
+				ai = V::Set1(a[5]);
+				c50 = V::FMA(ai, b0, c50); c51 = V::FMA(ai, b1, c51);
+			}
+
+			typename V::Reg acc[mr][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+			auto va = V::Set1(alpha);
+			auto vb = V::Set1(beta);
+			for (size_t i = 0; i < mr; i++, c += ldc)
+			{
+				if (beta == 0)
+				{
+					V::Store(c, V::Mul(acc[i][0], va));
+					V::Store(c + V::lanes, V::Mul(acc[i][1], va));
+				}
+				else
+				{
+					V::Store(c, V::FMA(acc[i][0], va, V::Mul(V::Load(c), vb)));
+					V::Store(c + V::lanes, V::FMA(acc[i][1], va, V::Mul(V::Load(c + V::lanes), vb)));
+				}
+			}
+		}
+	};
+
+	template<class Type>
+	struct GemmKernel<simd::Scalar, Type>
+	{
+		static constexpr size_t mr = 4;
+		static constexpr size_t nr = 4;
+
+		static void Run(size_t kc, const Type* a, const Type* b, Type* c, size_t ldc, Type alpha, Type beta)
+		{
+			Type acc[mr][nr] = {};
+			for (size_t k = 0; k < kc; k++, a += mr, b += nr)
+			{
+				for (size_t i = 0; i < mr; i++)
+					for (size_t j = 0; j < nr; j++)
+						acc[i][j] += a[i] * b[j];
+			}
+
+			for (size_t i = 0; i < mr; i++, c += ldc)
+			{
+				for (size_t j = 0; j < nr; j++)
+					c[j] = beta == 0 ? alpha * acc[i][j] : alpha * acc[i][j] + beta * c[j];
+			}
+		}
+	};
+#pragma endregion
+
+#pragma region Packing
+	// Am x k鰴mrһÿڰkУmrеĲֲ0
+	template<size_t MR, class Type>
+	static void PackA(const GemmMatrix<const Type>& A, size_t row, size_t col, size_t m, size_t k, Type* dst)
+	{
+		for (size_t i = 0; i < m; i += MR)
+		{
+			size_t rows = std::min(MR, m - i);
+			for (size_t p = 0; p < k; p++)
+			{
+				for (size_t r = 0; r < rows; r++) *dst++ = A(row + i + r, col + p);
+				for (size_t r = rows; r < MR; r++) *dst++ = 0;
+			}
+		}
+	}
+
+	// Bk x n鰴nrһÿڰkУnrеĲֲ0
+	template<size_t NR, class Type>
+	static void PackB(const GemmMatrix<const Type>& B, size_t row, size_t col, size_t k, size_t n, Type* dst)
+	{
+		for (size_t j = 0; j < n; j += NR)
+		{
+			size_t cols = std::min(NR, n - j);
+			Type* panel = dst + j * k;
+			for (size_t p = 0; p < k; p++)
+			{
+				const Type* src = &B(row + p, col + j);
+				if (B.cs == 1) memcpy(panel, src, cols * sizeof(Type));
+				else for (size_t c = 0; c < cols; c++) panel[c] = src[c * B.cs];
+				for (size_t c = cols; c < NR; c++) panel[c] = 0;
+				panel += NR;
+			}
+		}
+	}
+#pragma endregion
+
+	// ԴõA(m x k)B(k x n)΢ںˣдC(row, col)
+	template<class ISA, class Type>
+	static void MacroKernel(size_t m, size_t n, size_t k, const Type* a, const Type* b,
+		const GemmMatrix<Type>& C, size_t row, size_t col, Type alpha, Type beta)
+	{
+		using Kernel = GemmKernel<ISA, Type>;
+		constexpr size_t mr = Kernel::mr;
+		constexpr size_t nr = Kernel::nr;
+
+		for (size_t j = 0; j < n; j += nr)
+		{
+			size_t cols = std::min(nr, n - j);
+			for (size_t i = 0; i < m; i += mr)
+			{
+				size_t rows = std::min(mr, m - i);
+				Type* c = &C(row + i, col + j);
+				if (rows == mr && cols == nr && C.cs == 1)
+				{
+					Kernel::Run(k, a + i * k, b + j * k, c, C.rs, alpha, beta);
+					continue;
+				}
+
+				// ԵĿвC㵽ʱд
+				Type tmp[mr * nr];
+				Kernel::Run(k, a + i * k, b + j * k, tmp, nr, 1, 0);
+				for (size_t r = 0; r < rows; r++)
+				{
+					for (size_t s = 0; s < cols; s++)
+					{
+						Type& dst = C(row + i + r, col + j + s);
+						dst = beta == 0 ? alpha * tmp[r * nr + s] : alpha * tmp[r * nr + s] + beta * dst;
+					}
+				}
+			}
+		}
+	}
+
+	// һƽ棬parallelΪtrueʱAзֿ齻̳߳
+	template<class ISA, class Type>
+	static void GemmPlane(const GemmMatrix<const Type>& A, const GemmMatrix<const Type>& B, const GemmMatrix<Type>& C,
+		size_t M, size_t N, size_t K, Type alpha, Type beta, bool parallel)
+	{
+		using Kernel = GemmKernel<ISA, Type>;
+		constexpr size_t mr = Kernel::mr;
+		constexpr size_t nr = Kernel::nr;
+
+		if (K == 0 || alpha == 0)
+		{
+			for (size_t i = 0; i < M; i++)
+				for (size_t j = 0; j < N; j++)
+					C(i, j) = beta == 0 ? 0 : beta * C(i, j);
+			return;
+		}
+
+		// ʱСmcÿ̶ֵܷ߳
+		size_t threads = parallel ? GetNumThreads() : 1;
+		size_t mc = std::min(gemm_mc, std::max(mr, (M + threads - 1) / threads + mr - 1) / mr * mr);
+
+		size_t nc = std::min(gemm_nc, (N + nr - 1) / nr * nr);
+		std::vector<Type> packed_b(std::min(gemm_kc, K) * nc);
+
+		for (size_t jc = 0; jc < N; jc += nc)
+		{
+			size_t n = std::min(nc, N - jc);
+			for (size_t pc = 0; pc < K; pc += gemm_kc)
+			{
+				size_t k = std::min(gemm_kc, K - pc);
+				// ֻеһkʹbeta֮ۼӵC
+				Type beta_k = pc == 0 ? beta : 1;
+				PackB<nr>(B, pc, jc, k, n, packed_b.data());
+
+				auto body = [&](const Range& range) {
+					thread_local std::vector<Type> packed_a;
+					packed_a.resize(gemm_mc * gemm_kc);
+					for (size_t block = range.begin; block < range.end; block++)
+					{
+						size_t ic = block * mc;
+						size_t m = std::min(mc, M - ic);
+						PackA<mr>(A, ic, pc, m, k, packed_a.data());
+						MacroKernel<ISA>(m, n, k, packed_a.data(), packed_b.data(), C, ic, jc, alpha, beta_k);
+					}
+				};
+
+				Range blocks(0, (M + mc - 1) / mc);
+				if (parallel) ParallelFor(blocks, 1, body);
+				else body(blocks);
+			}
+		}
+	}
+
+	template<class ISA, class Type>
+	static void GemmImpl(const Mat& A, const Mat& B, Mat& C, double alpha, double beta, bool transA, bool transB)
+	{
+		size_t M = transA ? A.size[3] : A.size[2];
+		size_t K = transA ? A.size[2] : A.size[3];
+		size_t N = transB ? B.size[2] : B.size[3];
+
+		size_t batch = A.size[0] * A.size[1];
+		bool broadcast = B.size[0] * B.size[1] == 1;
+
+		auto plane = [](const Mat& mtx, size_t slice, bool trans) {
+			GemmMatrix<const Type> mat;
+			mat.data = mtx.GetPtr<Type>(slice / mtx.size[1], slice % mtx.size[1], 0, 0);
+			mat.rs = trans ? mtx.step[3] : mtx.step[2];
+			mat.cs = trans ? mtx.step[2] : mtx.step[3];
+			return mat;
+		};
+
+		// 㹻ʱβУÿڲ
+		bool batch_parallel = batch > 1 && batch >= GetNumThreads();
+		ParallelFor(Range(0, batch), batch_parallel ? 1 : batch, [&](const Range& range) {
+			for (size_t slice = range.begin; slice < range.end; slice++)
+			{
+				GemmMatrix<Type> c;
+				c.data = C.GetPtr<Type>(slice / C.size[1], slice % C.size[1], 0, 0);
+				c.rs = C.step[2];
+				c.cs = C.step[3];
+				GemmPlane<ISA>(plane(A, slice, transA), plane(B, broadcast ? 0 : slice, transB), c,
+					M, N, K, (Type)alpha, (Type)beta, !batch_parallel);
+			}
+		});
+	}
+
+	template<class Type>
+	static void GemmDispatch(const Mat& A, const Mat& B, Mat& C, double alpha, double beta, bool transA, bool transB)
+	{
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			GemmImpl<simd::AVX512, Type>(A, B, C, alpha, beta, transA, transB); break;
+		case SIMD_AVX2:
+			GemmImpl<simd::AVX2, Type>(A, B, C, alpha, beta, transA, transB); break;
+		case SIMD_SSE2:
+			GemmImpl<simd::SSE2, Type>(A, B, C, alpha, beta, transA, transB); break;
+		default:
+			GemmImpl<simd::Scalar, Type>(A, B, C, alpha, beta, transA, transB); break;
+		}
+	}
+
+	void Gemm(const Mat& A, const Mat& B, Mat& C, double alpha, double beta, bool transA, bool transB)
+	{
+		CHAOS_PROFILE_SCOPE("Gemm");
+		CHECK(nullptr != A.data_start && nullptr != B.data_start) << "Empty input.";
+		CHECK_EQ(A.depth, B.depth) << "A and B must have the same depth.";
+		CHECK(DEPTH_32F == A.depth || DEPTH_64F == A.depth) << "Gemm only supports DEPTH_32F and DEPTH_64F.";
+
+		size_t M = transA ? A.size[3] : A.size[2];
+		size_t K = transA ? A.size[2] : A.size[3];
+		size_t KB = transB ? B.size[3] : B.size[2];
+		size_t N = transB ? B.size[2] : B.size[3];
+		CHECK_EQ(K, KB) << "Inner dimensions mismatch, op(A) is " << M << "x" << K << " and op(B) is " << KB << "x" << N << ".";
+		CHECK(B.size[0] * B.size[1] == 1 || (B.size[0] == A.size[0] && B.size[1] == A.size[1]))
+			<< "B must have one plane or as many planes as A.";
+
+		MatSize size(A.size[0], A.size[1], M, N);
+		// CͬһMatʱдʱMat
+		if (&C == &A || &C == &B)
+		{
+			Mat tmp;
+			if (beta != 0) C.CopyTo(tmp);
+			Gemm(A, B, tmp, alpha, beta, transA, transB);
+			C = std::move(tmp);
+			return;
+		}
+
+		if (beta == 0)
+		{
+			C.Create(size, A.depth, false);
+		}
+		else
+		{
+			CHECK(C.size == size && C.depth == A.depth) << "C must be " << size << " with the same depth as A when beta is not zero.";
+		}
+
+		if (DEPTH_32F == A.depth) GemmDispatch<float>(A, B, C, alpha, beta, transA, transB);
+		else GemmDispatch<double>(A, B, C, alpha, beta, transA, transB);
+	}
+
+#pragma region Int8
+	// int8GEMMkÿ4Ԫƴһint32Ӧvpdpbusdpmaddubsw + pmaddwdһۼӵ4˻
+	// AһֻмʮKBBзֿint8BfloatС4kٷֿ
+	static constexpr size_t gemm_int8_nc = 512;
+
+	// AVX512F + AVX512-VNNI
+	struct VNNI {};
+
+	// c[mr x nr] = a * b - compaСbдcompֻbiasedʱʹ
+	template<class ISA> struct GemmInt8Kernel;
+
+	// vpdpbusd޷ x зţʱAÿֽڼ128ټȥ128 * Bк
+	template<> struct GemmInt8Kernel<VNNI>
+	{
+		static constexpr size_t mr = 6;
+		static constexpr size_t nr = 32;
+		static constexpr bool biased = true;
+
+		static void Run(size_t k4, const int* a, const int* b, int* c, size_t ldc, const int* comp)
+		{
+			__m512i c00 = _mm512_setzero_si512(), c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00;
+			__m512i c30 = c00, c31 = c00, c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+			for (size_t k = 0; k < k4; k++, a += mr, b += nr)
+			{
+				__m512i b0 = _mm512_loadu_si512(b);
+				__m512i b1 = _mm512_loadu_si512(b + 16);
+				__m512i ai = _mm512_set1_epi32(a[0]);
+				c00 = _mm512_dpbusd_epi32(c00, ai, b0); c01 = _mm512_dpbusd_epi32(c01, ai, b1);
+				ai = _mm512_set1_epi32(a[1]);
+				c10 = _mm512_dpbusd_epi32(c10, ai, b0); c11 = _mm512_dpbusd_epi32(c11, ai, b1);
+				ai = _mm512_set1_epi32(a[2]);
+				c20 = _mm512_dpbusd_epi32(c20, ai, b0); c21 = _mm512_dpbusd_epi32(c21, ai, b1);
+				ai = _mm512_set1_epi32(a[3]);
+				c30 = _mm512_dpbusd_epi32(c30, ai, b0); c31 = _mm512_dpbusd_epi32(c31, ai, b1);
+				ai = _mm512_set1_epi32(a[4]);
+				c40 = _mm512_dpbusd_epi32(c40, ai, b0); c41 = _mm512_dpbusd_epi32(c41, ai, b1);
+				ai = _mm512_set1_epi32(a[5]);
+				c50 = _mm512_dpbusd_epi32(c50, ai, b0); c51 = _mm512_dpbusd_epi32(c51, ai, b1);
+			}
+
+			__m512i acc[mr][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+			__m512i comp0 = _mm512_loadu_si512(comp);
+			__m512i comp1 = _mm512_loadu_si512(comp + 16);
+			for (size_t i = 0; i < mr; i++, c += ldc)
+			{
+				_mm512_storeu_si512(c, _mm512_sub_epi32(acc[i][0], comp0));
+				_mm512_storeu_si512(c + 16, _mm512_sub_epi32(acc[i][1], comp1));
+			}
+		}
+	};
+
+	// ûVNNIʱ|a| * (b * sign(a))|a| <= 128|b| <= 127pmaddubsw˻֮Ͳᱥ
+	template<> struct GemmInt8Kernel<simd::AVX512>
+	{
+		static constexpr size_t mr = 6;
+		static constexpr size_t nr = 32;
+		static constexpr bool biased = false;
+
+		// AVX512BWûvpsignbaΪֽȡ
+		static __m512i Dot(__m512i acc, __m512i a, __mmask64 neg, __m512i b)
+		{
+			b = _mm512_mask_sub_epi8(b, neg, _mm512_setzero_si512(), b);
+			return _mm512_add_epi32(acc, _mm512_madd_epi16(_mm512_maddubs_epi16(a, b), _mm512_set1_epi16(1)));
+		}
+
+		static void Run(size_t k4, const int* a, const int* b, int* c, size_t ldc, const int*)
+		{
+			__m512i c00 = _mm512_setzero_si512(), c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00;
+			__m512i c30 = c00, c31 = c00, c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+			for (size_t k = 0; k < k4; k++, a += mr, b += nr)
+			{
+				__m512i b0 = _mm512_loadu_si512(b);
+				__m512i b1 = _mm512_loadu_si512(b + 16);
+				__m512i ai = _mm512_set1_epi32(a[0]);
+				__mmask64 neg = _mm512_movepi8_mask(ai);
+				ai = _mm512_abs_epi8(ai);
+				c00 = Dot(c00, ai, neg, b0); c01 = Dot(c01, ai, neg, b1);
+				ai = _mm512_set1_epi32(a[1]);
+				neg = _mm512_movepi8_mask(ai);
+				ai = _mm512_abs_epi8(ai);
+				c10 = Dot(c10, ai, neg, b0); c11 = Dot(c11, ai, neg, b1);
+				ai = _mm512_set1_epi32(a[2]);
+				neg = _mm512_movepi8_mask(ai);
+				ai = _mm512_abs_epi8(ai);
+				c20 = Dot(c20, ai, neg, b0); c21 = Dot(c21, ai, neg, b1);
+				ai = _mm512_set1_epi32(a[3]);
+				neg = _mm512_movepi8_mask(ai);
+				ai = _mm512_abs_epi8(ai);
+				c30 = Dot(c30, ai, neg, b0); c31 = Dot(c31, ai, neg, b1);
+				ai = _mm512_set1_epi32(a[4]);
+				neg = _mm512_movepi8_mask(ai);
+				ai = _mm512_abs_epi8(ai);
+				c40 = Dot(c40, ai, neg, b0); c41 = Dot(c41, ai, neg, b1);
+				ai = _mm512_set1_epi32(a[5]);
+				neg = _mm512_movepi8_mask(ai);
+				ai = _mm512_abs_epi8(ai);
+				c50 = Dot(c50, ai, neg, b0); c51 = Dot(c51, ai, neg, b1);
+			}
+
+			__m512i acc[mr][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+			for (size_t i = 0; i < mr; i++, c += ldc)
+			{
+				_mm512_storeu_si512(c, acc[i][0]);
+				_mm512_storeu_si512(c + 16, acc[i][1]);
+			}
+		}
+	};
+
+	// ͬϣAVX2ֻ16ĴmrΪ4
+	template<> struct GemmInt8Kernel<simd::AVX2>
+	{
+		static constexpr size_t mr = 4;
+		static constexpr size_t nr = 16;
+		static constexpr bool biased = false;
+
+		static __m256i Dot(__m256i acc, __m256i abs_a, __m256i a, __m256i b)
+		{
+			__m256i prod = _mm256_maddubs_epi16(abs_a, _mm256_sign_epi8(b, a));
+			return _mm256_add_epi32(acc, _mm256_madd_epi16(prod, _mm256_set1_epi16(1)));
+		}
+
+		static void Run(size_t k4, const int* a, const int* b, int* c, size_t ldc, const int*)
+		{
+			__m256i c00 = _mm256_setzero_si256(), c01 = c00, c10 = c00, c11 = c00;
+			__m256i c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+			for (size_t k = 0; k < k4; k++, a += mr, b += nr)
+			{
+				__m256i b0 = _mm256_loadu_si256((const __m256i*)b);
+				__m256i b1 = _mm256_loadu_si256((const __m256i*)(b + 8));
+				__m256i ai = _mm256_set1_epi32(a[0]);
+				__m256i abs_a = _mm256_abs_epi8(ai);
+				c00 = Dot(c00, abs_a, ai, b0); c01 = Dot(c01, abs_a, ai, b1);
+				ai = _mm256_set1_epi32(a[1]);
+				abs_a = _mm256_abs_epi8(ai);
+				c10 = Dot(c10, abs_a, ai, b0); c11 = Dot(c11, abs_a, ai, b1);
+				ai = _mm256_set1_epi32(a[2]);
+				abs_a = _mm256_abs_epi8(ai);
+				c20 = Dot(c20, abs_a, ai, b0); c21 = Dot(c21, abs_a, ai, b1);
+				ai = _mm256_set1_epi32(a[3]);
+				abs_a = _mm256_abs_epi8(ai);
+				c30 = Dot(c30, abs_a, ai, b0); c31 = Dot(c31, abs_a, ai, b1);
+			}
+
+			__m256i acc[mr][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 } };
+			for (size_t i = 0; i < mr; i++, c += ldc)
+			{
+				_mm256_storeu_si256((__m256i*)c, acc[i][0]);
+				_mm256_storeu_si256((__m256i*)(c + 8), acc[i][1]);
+			}
+		}
+	};
+
+	// SSE2ûpmaddubswʹ
+	template<> struct GemmInt8Kernel<simd::Scalar>
+	{
+		static constexpr size_t mr = 4;
+		static constexpr size_t nr = 4;
+		static constexpr bool biased = false;
+
+		static void Run(size_t k4, const int* a, const int* b, int* c, size_t ldc, const int*)
+		{
+			int acc[mr][nr] = {};
+			for (size_t k = 0; k < k4; k++, a += mr, b += nr)
+			{
+				const char* pa = (const char*)a;
+				const char* pb = (const char*)b;
+				for (size_t i = 0; i < mr; i++)
+					for (size_t j = 0; j < nr; j++)
+						for (size_t t = 0; t < 4; t++)
+							acc[i][j] += pa[i * 4 + t] * pb[j * 4 + t];
+			}
+
+			for (size_t i = 0; i < mr; i++, c += ldc)
+			{
+				for (size_t j = 0; j < nr; j++) c[j] = acc[i][j];
+			}
+		}
+	};
+
+	// AM x Kmrһÿÿ4kƴһint32Ĳֲ0
+	template<class Kernel>
+	static void PackAInt8(const GemmMatrix<const char>& A, size_t M, size_t K, int* dst)
+	{
+		constexpr size_t mr = Kernel::mr;
+		size_t k4 = (K + 3) / 4;
+		for (size_t i = 0; i < M; i += mr)
+		{
+			size_t rows = std::min(mr, M - i);
+			for (size_t p = 0; p < k4; p++)
+			{
+				for (size_t r = 0; r < mr; r++, dst++)
+				{
+					char v[4] = {};
+					for (size_t t = 0; r < rows && t < 4 && 4 * p + t < K; t++) v[t] = A(i + r, 4 * p + t);
+					if (Kernel::biased) for (size_t t = 0; t < 4; t++) v[t] ^= (char)0x80;
+					memcpy(dst, v, 4);
+				}
+			}
+		}
+	}
+
+	// pmaddubswķתƶBȡ-128ȡں˶Bе-128-127㣬ָ޹
+	static inline char ClampB(char value) { return std::max(value, (char)-127); }
+
+	// BK x n鰴nrһÿÿ4kƴһint32Ĳֲ0
+	// biasedʱcompΪ128 * ÿеĺ
+	template<class Kernel>
+	static void PackBInt8(const GemmMatrix<const char>& B, size_t col, size_t K, size_t n, int* dst, int* comp)
+	{
+		constexpr size_t nr = Kernel::nr;
+		size_t k4 = (K + 3) / 4;
+		for (size_t j = 0; j < n; j += nr)
+		{
+			size_t cols = std::min(nr, n - j);
+			int* panel = dst + j * k4;
+			for (size_t p = 0; p < k4; p++)
+			{
+				const char* rows[4] = {};
+				for (size_t t = 0; t < 4 && 4 * p + t < K; t++) rows[t] = &B(4 * p + t, col + j);
+				for (size_t c = 0; c < nr; c++, panel++)
+				{
+					char v[4] = {};
+					for (size_t t = 0; c < cols && t < 4; t++) v[t] = rows[t] ? ClampB(rows[t][c * B.cs]) : 0;
+					memcpy(panel, v, 4);
+				}
+			}
+
+			if (Kernel::biased)
+			{
+				for (size_t c = 0; c < nr; c++)
+				{
+					int sum = 0;
+					for (size_t k = 0; c < cols && k < K; k++) sum += ClampB(B(k, col + j + c));
+					comp[j + c] = 128 * sum;
+				}
+			}
+		}
+	}
+
+	// ԴõA(m x K)B(K x n)΢ںˣдC(row, col)
+	template<class Kernel>
+	static void MacroKernelInt8(size_t m, size_t n, size_t k4, const int* a, const int* b, const int* comp,
+		const GemmMatrix<int>& C, size_t row, size_t col)
+	{
+		constexpr size_t mr = Kernel::mr;
+		constexpr size_t nr = Kernel::nr;
+
+		for (size_t j = 0; j < n; j += nr)
+		{
+			size_t cols = std::min(nr, n - j);
+			for (size_t i = 0; i < m; i += mr)
+			{
+				size_t rows = std::min(mr, m - i);
+				int* c = &C(row + i, col + j);
+				if (rows == mr && cols == nr && C.cs == 1)
+				{
+					Kernel::Run(k4, a + i * k4, b + j * k4, c, C.rs, comp + j);
+					continue;
+				}
+
+				int tmp[mr * nr];
+				Kernel::Run(k4, a + i * k4, b + j * k4, tmp, nr, comp + j);
+				for (size_t r = 0; r < rows; r++)
+					for (size_t s = 0; s < cols; s++)
+						C(row + i + r, col + j + s) = tmp[r * nr + s];
+			}
+		}
+	}
+
+	template<class Kernel>
+	static void GemmInt8Plane(const GemmMatrix<const char>& A, const GemmMatrix<const char>& B, const GemmMatrix<int>& C,
+		size_t M, size_t N, size_t K, bool parallel)
+	{
+		constexpr size_t mr = Kernel::mr;
+		constexpr size_t nr = Kernel::nr;
+
+		if (K == 0)
+		{
+			for (size_t i = 0; i < M; i++)
+				for (size_t j = 0; j < N; j++)
+					C(i, j) = 0;
+			return;
+		}
+
+		size_t k4 = (K + 3) / 4;
+		std::vector<int> packed_a((M + mr - 1) / mr * mr * k4);
+		PackAInt8<Kernel>(A, M, K, packed_a.data());
+
+		size_t threads = parallel ? GetNumThreads() : 1;
+		size_t mc = std::min(gemm_mc, std::max(mr, (M + threads - 1) / threads + mr - 1) / mr * mr);
+
+		size_t nc = std::min(gemm_int8_nc, (N + nr - 1) / nr * nr);
+		std::vector<int> packed_b(k4 * nc), comp(nc);
+		for (size_t jc = 0; jc < N; jc += nc)
+		{
+			size_t n = std::min(nc, N - jc);
+			PackBInt8<Kernel>(B, jc, K, n, packed_b.data(), comp.data());
+
+			auto body = [&](const Range& range) {
+				for (size_t block = range.begin; block < range.end; block++)
+				{
+					size_t ic = block * mc;
+					MacroKernelInt8<Kernel>(std::min(mc, M - ic), n, k4, packed_a.data() + ic * k4, packed_b.data(), comp.data(), C, ic, jc);
+				}
+			};
+
+			Range blocks(0, (M + mc - 1) / mc);
+			if (parallel) ParallelFor(blocks, 1, body);
+			else body(blocks);
+		}
+	}
+
+	template<class Kernel>
+	static void GemmInt8Impl(const Mat& A, const Mat& B, Mat& C, bool transA, bool transB)
+	{
+		size_t M = transA ? A.size[3] : A.size[2];
+		size_t K = transA ? A.size[2] : A.size[3];
+		size_t N = transB ? B.size[2] : B.size[3];
+
+		size_t batch = A.size[0] * A.size[1];
+		bool broadcast = B.size[0] * B.size[1] == 1;
+
+		auto plane = [](const Mat& mtx, size_t slice, bool trans) {
+			GemmMatrix<const char> mat;
+			mat.data = mtx.GetPtr<char>(slice / mtx.size[1], slice % mtx.size[1], 0, 0);
+			mat.rs = trans ? mtx.step[3] : mtx.step[2];
+			mat.cs = trans ? mtx.step[2] : mtx.step[3];
+			return mat;
+		};
+
+		bool batch_parallel = batch > 1 && batch >= GetNumThreads();
+		ParallelFor(Range(0, batch), batch_parallel ? 1 : batch, [&](const Range& range) {
+			for (size_t slice = range.begin; slice < range.end; slice++)
+			{
+				GemmMatrix<int> c;
+				c.data = C.GetPtr<int>(slice / C.size[1], slice % C.size[1], 0, 0);
+				c.rs = C.step[2];
+				c.cs = C.step[3];
+				GemmInt8Plane<Kernel>(plane(A, slice, transA), plane(B, broadcast ? 0 : slice, transB), c, M, N, K, !batch_parallel);
+			}
+		});
+	}
+#pragma endregion
+
+	void GemmInt8(const Mat& A, const Mat& B, Mat& C, bool transA, bool transB)
+	{
+		CHAOS_PROFILE_SCOPE("GemmInt8");
+		CHECK(nullptr != A.data_start && nullptr != B.data_start) << "Empty input.";
+		CHECK(DEPTH_8S == A.depth && DEPTH_8S == B.depth) << "GemmInt8 only supports DEPTH_8S.";
+
+		size_t M = transA ? A.size[3] : A.size[2];
+		size_t K = transA ? A.size[2] : A.size[3];
+		size_t KB = transB ? B.size[3] : B.size[2];
+		size_t N = transB ? B.size[2] : B.size[3];
+		CHECK_EQ(K, KB) << "Inner dimensions mismatch, op(A) is " << M << "x" << K << " and op(B) is " << KB << "x" << N << ".";
+		CHECK(B.size[0] * B.size[1] == 1 || (B.size[0] == A.size[0] && B.size[1] == A.size[1]))
+			<< "B must have one plane or as many planes as A.";
+
+		if (&C == &A || &C == &B)
+		{
+			Mat tmp;
+			GemmInt8(A, B, tmp, transA, transB);
+			C = std::move(tmp);
+			return;
+		}
+
+		C.Create(MatSize(A.size[0], A.size[1], M, N), DEPTH_32S, false);
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			if (CheckHardwareSupport(CPU_AVX512VNNI)) GemmInt8Impl<GemmInt8Kernel<VNNI>>(A, B, C, transA, transB);
+			else GemmInt8Impl<GemmInt8Kernel<simd::AVX512>>(A, B, C, transA, transB);
+			break;
+		case SIMD_AVX2:
+			GemmInt8Impl<GemmInt8Kernel<simd::AVX2>>(A, B, C, transA, transB); break;
+		default:
+			GemmInt8Impl<GemmInt8Kernel<simd::Scalar>>(A, B, C, transA, transB); break;
+		}
+	}
+
+} // namespace chaos
@@ -0,0 +1,83 @@
+#include "core\half.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+
+namespace chaos
+{
+#pragma region Kernels
+	template<class ISA, class Half>
+	static void ToFloatRow(const Half* src, float* dst, size_t len)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using C = simd::Cvt<ISA>;
+			for (; i + C::lanes <= len; i += C::lanes) simd::Vec<ISA, float>::Store(dst + i, C::LoadF32(src + i));
+		}
+		for (; i < len; i++) dst[i] = Half::ToFloat(src[i].bits);
+	}
+
+	template<class ISA, class Half>
+	static void FromFloatRow(const float* src, Half* dst, size_t len)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using C = simd::Cvt<ISA>;
+			for (; i + C::lanes <= len; i += C::lanes) C::StoreF32(dst + i, simd::Vec<ISA, float>::Load(src + i));
+		}
+		for (; i < len; i++) dst[i].bits = Half::FromFloat(src[i]);
+	}
+
+	// SSE2ûF16CתƴװĴ
+	template<class Half>
+	static void ToFloatDispatch(const Half* src, float* dst, size_t len)
+	{
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			ToFloatRow<simd::AVX512>(src, dst, len); break;
+		case SIMD_AVX2:
+			ToFloatRow<simd::AVX2>(src, dst, len); break;
+		default:
+			ToFloatRow<simd::Scalar>(src, dst, len); break;
+		}
+	}
+
+	template<class Half>
+	static void FromFloatDispatch(const float* src, Half* dst, size_t len)
+	{
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			FromFloatRow<simd::AVX512>(src, dst, len); break;
+		case SIMD_AVX2:
+			FromFloatRow<simd::AVX2>(src, dst, len); break;
+		default:
+			FromFloatRow<simd::Scalar>(src, dst, len); break;
+		}
+	}
+#pragma endregion
+
+	void ToFloat(const float16* src, float* dst, size_t len)
+	{
+		ToFloatDispatch(src, dst, len);
+	}
+
+	void ToFloat(const bfloat16* src, float* dst, size_t len)
+	{
+		ToFloatDispatch(src, dst, len);
+	}
+
+	void FromFloat(const float* src, float16* dst, size_t len)
+	{
+		FromFloatDispatch(src, dst, len);
+	}
+
+	void FromFloat(const float* src, bfloat16* dst, size_t len)
+	{
+		FromFloatDispatch(src, dst, len);
+	}
+
+} // namespace chaos
@@ -0,0 +1,355 @@
+#include "core\mat.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+#include "core\parallel.hpp"
+
+namespace chaos
+{
+	// СĿnon-temporal storeƹ棬ѻݼȥ
+	static constexpr size_t stream_threshold = (size_t)4 << 20;
+	// СĿָ̣߳ÿ߳ٿô
+	static constexpr size_t parallel_grain = (size_t)4 << 20;
+
+#pragma region Copy
+	// ĿȰ64ֽڶ룬м䲿ֱдڴ治
+	template<class ISA>
+	static void StreamCopy(uchar* dst, const uchar* src, size_t bytes)
+	{
+		size_t head = std::min(bytes, (64 - ((size_t)dst & 63)) & 63);
+		memcpy(dst, src, head);
+		dst += head; src += head; bytes -= head;
+
+		size_t i = 0;
+		for (; i + 64 <= bytes; i += 64)
+		{
+			if constexpr (std::is_same<ISA, simd::AVX512>::value)
+			{
+				_mm512_stream_si512((__m512i*)(dst + i), _mm512_loadu_si512(src + i));
+			}
+			else if constexpr (std::is_same<ISA, simd::AVX2>::value)
+			{
+				_mm256_stream_si256((__m256i*)(dst + i), _mm256_loadu_si256((const __m256i*)(src + i)));
+				_mm256_stream_si256((__m256i*)(dst + i + 32), _mm256_loadu_si256((const __m256i*)(src + i + 32)));
+			}
+			else
+			{
+				for (size_t k = 0; k < 64; k += 16)
+					_mm_stream_si128((__m128i*)(dst + i + k), _mm_loadu_si128((const __m128i*)(src + i + k)));
+			}
+		}
+		memcpy(dst + i, src + i, bytes - i);
+	}
+
+	static void CopyBytes(uchar* dst, const uchar* src, size_t bytes, bool stream)
+	{
+		if (dst == src) return;
+		if (!stream || bytes < 256)
+		{
+			memcpy(dst, src, bytes);
+			return;
+		}
+
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			StreamCopy<simd::AVX512>(dst, src, bytes); break;
+		case SIMD_AVX2:
+			StreamCopy<simd::AVX2>(dst, src, bytes); break;
+		case SIMD_SSE2:
+			StreamCopy<simd::SSE2>(dst, src, bytes); break;
+		default:
+			memcpy(dst, src, bytes); break;
+		}
+	}
+
+	// пMatֻһУĿлֽ߰ڷָ߳
+	static void CopyRows(const MatRowIterator& it, size_t elem_size)
+	{
+		size_t row_bytes = it.length * elem_size;
+		size_t total = it.rows * row_bytes;
+		bool stream = total >= stream_threshold;
+
+		if (total < 2 * parallel_grain)
+		{
+			for (size_t row = 0; row < it.rows; row++)
+				CopyBytes(it.Ptr(1, row), it.Ptr(0, row), row_bytes, stream);
+			if (stream) _mm_sfence();
+		}
+		else if (it.rows == 1)
+		{
+			uchar* src = it.Ptr(0, 0);
+			uchar* dst = it.Ptr(1, 0);
+			size_t chunks = total / parallel_grain;
+			ParallelFor(Range(0, chunks), 1, [&](const Range& range) {
+				// ÿΰ64ֽڶз
+				size_t from = total * range.begin / chunks & ~(size_t)63;
+				size_t to = range.end == chunks ? total : total * range.end / chunks & ~(size_t)63;
+				CopyBytes(dst + from, src + from, to - from, stream);
+				if (stream) _mm_sfence();
+			});
+		}
+		else
+		{
+			ParallelFor(Range(0, it.rows), std::max((size_t)1, parallel_grain / row_bytes), [&](const Range& range) {
+				for (size_t row = range.begin; row < range.end; row++)
+					CopyBytes(it.Ptr(1, row), it.Ptr(0, row), row_bytes, stream);
+				if (stream) _mm_sfence();
+			});
+		}
+	}
+#pragma endregion
+
+	template<size_t Bytes> struct ElemType;
+	template<> struct ElemType<1> { using Type = uint8_t; };
+	template<> struct ElemType<2> { using Type = uint16_t; };
+	template<> struct ElemType<4> { using Type = uint32_t; };
+	template<> struct ElemType<8> { using Type = uint64_t; };
+
+	template<size_t Bytes>
+	static inline void CopyElem(uchar* dst, const uchar* src)
+	{
+		using Type = typename ElemType<Bytes>::Type;
+		*(Type*)dst = *(const Type*)src;
+	}
+
+	// ̶ͨʱչڲѭزChannelsƽ棨Split߷Merge
+	// 8λAVX2pshufbһδ16
+	template<class ISA, size_t Bytes, size_t Channels>
+	static void SplitChannels(const uchar* src, uchar* dst, size_t plane_step, size_t pixels)
+	{
+		using Type = typename ElemType<Bytes>::Type;
+
+		size_t i = 0;
+		if constexpr (1 == Bytes && (std::is_same<ISA, simd::AVX2>::value || std::is_same<ISA, simd::AVX512>::value))
+		{
+			using Kernel = simd::Interleave8<Channels>;
+			for (; i + Kernel::pixels <= pixels; i += Kernel::pixels)
+				Kernel::Split(src + i * Channels, dst + i, plane_step);
+		}
+
+		// ֻþֲıucharдָ֮ıÿζ¶ȡ
+		const Type* in = (const Type*)src + i * Channels;
+		Type* out = (Type*)dst + i;
+		const size_t step = plane_step / Bytes;
+		for (; i < pixels; i++, in += Channels, out++)
+		{
+			for (size_t c = 0; c < Channels; c++) out[c * step] = in[c];
+		}
+	}
+
+	template<class ISA, size_t Bytes, size_t Channels>
+	static void MergeChannels(const uchar* src, size_t plane_step, uchar* dst, size_t pixels)
+	{
+		using Type = typename ElemType<Bytes>::Type;
+
+		size_t i = 0;
+		if constexpr (1 == Bytes && (std::is_same<ISA, simd::AVX2>::value || std::is_same<ISA, simd::AVX512>::value))
+		{
+			using Kernel = simd::Interleave8<Channels>;
+			for (; i + Kernel::pixels <= pixels; i += Kernel::pixels)
+				Kernel::Merge(src + i, plane_step, dst + i * Channels);
+		}
+
+		const Type* in = (const Type*)src + i;
+		Type* out = (Type*)dst + i * Channels;
+		const size_t step = plane_step / Bytes;
+		for (; i < pixels; i++, in++, out += Channels)
+		{
+			for (size_t c = 0; c < Channels; c++) out[c] = in[c * step];
+		}
+	}
+
+	// ֿתãÿԴĿ궼ܷŽL1ٰtileSIMDں
+	// ֽΪλdst[j][i] = src[i][j]srcΪrows x cols
+	template<class ISA, size_t Bytes>
+	static void TransposePlane(const uchar* src, size_t src_step, uchar* dst, size_t dst_step, size_t rows, size_t cols)
+	{
+		using Kernel = simd::Transpose<ISA, Bytes>;
+		constexpr size_t block = 64;
+		constexpr size_t tile = Kernel::tile;
+
+		// 34ͨͼղһtileزֻߺϲ
+		if (3 == cols && 3 * Bytes == src_step)
+			return SplitChannels<ISA, Bytes, 3>(src, dst, dst_step, rows);
+		if (4 == cols && 4 * Bytes == src_step)
+			return SplitChannels<ISA, Bytes, 4>(src, dst, dst_step, rows);
+		if (3 == rows && 3 * Bytes == dst_step)
+			return MergeChannels<ISA, Bytes, 3>(src, src_step, dst, cols);
+		if (4 == rows && 4 * Bytes == dst_step)
+			return MergeChannels<ISA, Bytes, 4>(src, src_step, dst, cols);
+
+		if (cols < tile || rows < tile)
+		{
+			for (size_t i = 0; i < rows; i++)
+			{
+				for (size_t j = 0; j < cols; j++)
+					CopyElem<Bytes>(dst + j * dst_step + i * Bytes, src + i * src_step + j * Bytes);
+			}
+			return;
+		}
+
+		for (size_t bi = 0; bi < rows; bi += block)
+		{
+			size_t ei = std::min(bi + block, rows);
+			for (size_t bj = 0; bj < cols; bj += block)
+			{
+				size_t ej = std::min(bj + block, cols);
+
+				size_t i = bi;
+				for (; i + tile <= ei; i += tile)
+				{
+					size_t j = bj;
+					for (; j + tile <= ej; j += tile)
+					{
+						Kernel::Tile(src + i * src_step + j * Bytes, src_step, dst + j * dst_step + i * Bytes, dst_step);
+					}
+					for (; j < ej; j++)
+					{
+						for (size_t k = i; k < i + tile; k++)
+							CopyElem<Bytes>(dst + j * dst_step + k * Bytes, src + k * src_step + j * Bytes);
+					}
+				}
+				for (; i < ei; i++)
+				{
+					for (size_t j = bj; j < ej; j++)
+						CopyElem<Bytes>(dst + j * dst_step + i * Bytes, src + i * src_step + j * Bytes);
+				}
+			}
+		}
+	}
+
+	template<size_t Bytes>
+	static void TransposePlane(const uchar* src, size_t src_step, uchar* dst, size_t dst_step, size_t rows, size_t cols)
+	{
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			TransposePlane<simd::AVX512, Bytes>(src, src_step, dst, dst_step, rows, cols); break;
+		case SIMD_AVX2:
+			TransposePlane<simd::AVX2, Bytes>(src, src_step, dst, dst_step, rows, cols); break;
+		case SIMD_SSE2:
+			TransposePlane<simd::SSE2, Bytes>(src, src_step, dst, dst_step, rows, cols); break;
+		default:
+			TransposePlane<simd::Scalar, Bytes>(src, src_step, dst, dst_step, rows, cols); break;
+		}
+	}
+
+	static void TransposePlane(size_t elem_size, const uchar* src, size_t src_step, uchar* dst, size_t dst_step, size_t rows, size_t cols)
+	{
+		switch (elem_size)
+		{
+		case 1:
+			TransposePlane<1>(src, src_step, dst, dst_step, rows, cols); break;
+		case 2:
+			TransposePlane<2>(src, src_step, dst, dst_step, rows, cols); break;
+		case 4:
+			TransposePlane<4>(src, src_step, dst, dst_step, rows, cols); break;
+		case 8:
+			TransposePlane<8>(src, src_step, dst, dst_step, rows, cols); break;
+		default:
+			LOG(FATAL) << "Unsupported element size " << elem_size;
+		}
+	}
+
+	// Ϊ1άȣûʱ-1
+	static int UnitAxis(const Mat& mtx)
+	{
+		for (int axis = 3; axis >= 0; axis--)
+		{
+			if (mtx.size[axis] > 1 && mtx.step[axis] == 1) return axis;
+		}
+		return -1;
+	}
+
+	// ⲽMat֮俽״ͬ
+	// ڲάͬʱпͬʱNCHWNHWC֮䣩ƽת
+	static void CopyStrided(const Mat& src, Mat& dst)
+	{
+		size_t elem_size = ElemSize(src.depth);
+
+		MatRowIterator it({ &src, &dst });
+		int src_axis = UnitAxis(src), dst_axis = UnitAxis(dst);
+		if (it.length > 1 || src_axis < 0 || dst_axis < 0 || src_axis == dst_axis)
+		{
+			CopyRows(it, elem_size);
+			return;
+		}
+
+		// srcdst_axissrc_axisdst෴
+		size_t rows = src.size[dst_axis], cols = src.size[src_axis];
+		size_t src_row_step = src.step[dst_axis], dst_row_step = dst.step[src_axis];
+
+		// ܽлάȲÿƽ澡
+		int outer[2], outer_cnt = 0;
+		for (int axis = 0; axis < 4; axis++)
+		{
+			if (axis == src_axis || axis == dst_axis || src.size[axis] == 1) continue;
+			outer[outer_cnt++] = axis;
+		}
+		for (bool merged = true; merged;)
+		{
+			merged = false;
+			for (int i = 0; i < outer_cnt; i++)
+			{
+				int axis = outer[i];
+				if (src.step[axis] == cols && dst.step[axis] == cols * dst_row_step)
+					cols *= src.size[axis];
+				else if (dst.step[axis] == rows && src.step[axis] == rows * src_row_step)
+					rows *= src.size[axis];
+				else continue;
+
+				outer[i] = outer[--outer_cnt];
+				merged = true;
+				break;
+			}
+		}
+
+		size_t planes = 1;
+		for (int i = 0; i < outer_cnt; i++) planes *= src.size[outer[i]];
+		for (size_t p = 0; p < planes; p++)
+		{
+			size_t src_offset = 0, dst_offset = 0, idx = p;
+			for (int i = outer_cnt - 1; i >= 0; i--)
+			{
+				int axis = outer[i];
+				src_offset += (idx % src.size[axis]) * src.step[axis];
+				dst_offset += (idx % src.size[axis]) * dst.step[axis];
+				idx /= src.size[axis];
+			}
+			TransposePlane(elem_size, src.data_start + src_offset * elem_size, src_row_step * elem_size,
+				dst.data_start + dst_offset * elem_size, dst_row_step * elem_size, rows, cols);
+		}
+	}
+
+	void Mat::CopyTo(Mat& dst) const
+	{
+		CHAOS_PROFILE_SCOPE("CopyTo");
+		CHECK(nullptr != data_start) << "Empty input.";
+		if (&dst == this) return;
+
+		dst.Create(size, depth, false, layout);
+		CopyStrided(*this, dst);
+	}
+
+	void Mat::ToLayout(Mat& dst, MatLayout layout) const
+	{
+		CHAOS_PROFILE_SCOPE("ToLayout");
+		CHECK(nullptr != data_start) << "Empty input.";
+
+		// ԭŻdstвʱдµMat
+		if (&dst == this || dst.layout != layout)
+		{
+			Mat tmp;
+			tmp.allocator = dst.allocator;
+			tmp.Create(size, depth, false, layout);
+			CopyStrided(*this, tmp);
+			dst = std::move(tmp);
+			return;
+		}
+
+		dst.Create(size, depth, false, layout);
+		CopyStrided(*this, dst);
+	}
+
+} // namespace chaos
@@ -4,39 +4,288 @@
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <charconv>
 
 namespace chaos
 {
 	DEFINE_STRING(log_dir, "", "Log DIR");
+	DEFINE_BOOL(log_microseconds, false, "show microseconds in log timestamps.");
+	DEFINE_INT(v, 0, "show all VLOG(m) messages for m <= this.");
+	DEFINE_BOOL(log_async, false, "write logs from a background thread, FATAL is still written synchronously.");
+
+	// ־ˣļֻһΣlog_dirlog_nameıʱ´
+	class LogSink
+	{
+	public:
+		static LogSink& Get()
+		{
+			static LogSink sink;
+			return sink;
+		}
+
+		// text԰־ÿԻнβ
+		void Write(const std::string& text, bool flush)
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			std::cout.write(text.data(), text.size());
+			if (flush) std::cout.flush();
+
+			if (flag_log_dir.empty()) return;
+
+			std::string path = flag_log_dir + "\\" + LogMessage::log_name;
+			if (path != file_path)
+			{
+				file.close();
+				file.open(path, std::ios::out | std::ios::app | std::ios::binary);
+				file_path = path;
+			}
+			if (file.is_open())
+			{
+				file.write(text.data(), text.size());
+				if (flush) file.flush();
+			}
+		}
+
+	private:
+		std::mutex mtx;
+		std::ofstream file;
+		std::string file_path;
+	};
+
+	// ߵߵн绷ζУÿ۴һ
+	// ֻ֮һheadϵCAS߲ҪκԭӵĶд
+	class LogQueue
+	{
+	public:
+		LogQueue() : slots(new Slot[capacity])
+		{
+			for (size_t i = 0; i < capacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		bool TryPush(std::string& message)
+		{
+			size_t pos = head.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Slot& slot = slots[pos & (capacity - 1)];
+				size_t seq = slot.sequence.load(std::memory_order_acquire);
+				if (seq == pos)
+				{
+					if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						slot.message.swap(message);
+						slot.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (seq < pos)
+				{
+					return false; // 
+				}
+				else
+				{
+					pos = head.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool TryPop(std::string& message)
+		{
+			Slot& slot = slots[tail & (capacity - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+
+			message.swap(slot.message);
+			slot.message.clear();
+			slot.sequence.store(tail + capacity, std::memory_order_release);
+			tail++;
+			return true;
+		}
+
+	private:
+		struct Slot
+		{
+			std::atomic<size_t> sequence;
+			std::string message;
+		};
+
+		static constexpr size_t capacity = 1 << 13;
+
+		std::unique_ptr<Slot[]> slots;
+		alignas(64) std::atomic<size_t> head{ 0 };
+		alignas(64) size_t tail = 0; // ֻд̷߳
+	};
+
+	// ̨д̣߳Ѷе־ܳһдʱˢ»
+	class AsyncLogger
+	{
+	public:
+		static AsyncLogger& Get()
+		{
+			static AsyncLogger logger;
+			return logger;
+		}
+
+		AsyncLogger()
+		{
+			// ȹsink֤logger֮
+			LogSink::Get();
+		}
+
+		~AsyncLogger()
+		{
+			stop = true;
+			cv.notify_one();
+			if (writer.joinable()) writer.join();
+			// ˳ʱд߳̿Ѿˣʣµڵǰ߳д
+			Drain();
+		}
+
+		void Push(std::string&& message)
+		{
+			std::call_once(started, [this]() { writer = std::thread(&AsyncLogger::Run, this); });
+
+			message.push_back('\n');
+			// ʱȴд̣߳־
+			while (!queue.TryPush(message))
+			{
+				cv.notify_one();
+				std::this_thread::yield();
+			}
+			pushed.fetch_add(1, std::memory_order_release);
+			if (waiting.load(std::memory_order_relaxed)) cv.notify_one();
+		}
+
+		// ڵǰ̰߳ѵ֮ǰύ־дд߳
+		void Flush()
+		{
+			size_t target = pushed.load(std::memory_order_acquire);
+			while (written.load(std::memory_order_acquire) < target)
+			{
+				if (0 == Drain()) std::this_thread::yield();
+			}
+		}
+
+	private:
+		void Run()
+		{
+			while (!stop)
+			{
+				if (0 == Drain())
+				{
+					std::unique_lock<std::mutex> lock(mtx);
+					waiting = true;
+					cv.wait_for(lock, std::chrono::milliseconds(10));
+					waiting = false;
+				}
+			}
+			Drain();
+		}
+
+		// де־
+		size_t Drain()
+		{
+			std::lock_guard<std::mutex> lock(drain_mtx);
+			size_t total = 0;
+			std::string message;
+			while (queue.TryPop(message))
+			{
+				size_t count = 1;
+				batch += message;
+				while (batch.size() < batch_bytes && queue.TryPop(message))
+				{
+					batch += message;
+					count++;
+				}
+				LogSink::Get().Write(batch, true);
+				batch.clear();
+				written.fetch_add(count, std::memory_order_release);
+				total += count;
+			}
+			return total;
+		}
+
+		static constexpr size_t batch_bytes = 64 << 10;
+
+		LogQueue queue;
+		std::string batch;
+		std::thread writer;
+		std::once_flag started;
+		std::mutex mtx;
+		std::mutex drain_mtx;
+		std::condition_variable cv;
+		std::atomic<bool> stop{ false };
+		std::atomic<bool> waiting{ false };
+		std::atomic<size_t> pushed{ 0 };
+		std::atomic<size_t> written{ 0 };
+	};
 
 	std::string LogMessage::log_name = "";
-	std::mutex LogMessage::mtx;
 	int LogMessage::log_level = 0;
 	std::vector<std::string> LogMessage::log_severity_text{ "INFO", "WARNING", "ERROR", "FATAL" };
 
-	LogMessage::LogMessage(const char* file, int line, LogSeverity severity)
-		: severity(severity)
+	// ͬһڵ־øʽõʱ䣬ÿ߳һݣҪ
+	static size_t FormatTime(char* buff)
 	{
-		//static std::vector<std::string> log_severity_text{ "INFO", "WARNING", "ERROR", "FATAL" };
-		// ȡļ
-		std::string _file(file);
-		int pos = _file.find_last_of('\\') + 1;
+		struct TimeCache
+		{
+			time_t second = -1;
+			char text[24];
+			size_t length = 0;
+		};
+		static thread_local TimeCache cache;
 
-		std::string severity_str;
+		auto now = std::chrono::system_clock::now();
+		time_t second = std::chrono::system_clock::to_time_t(now);
+		if (second != cache.second)
+		{
+			tm time;
+			localtime_s(&time, &second); // ̰߳ȫ汾ͬʱʹָ
+			cache.length = strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &time);
+			cache.second = second;
+		}
 
-		//// ʱȱǩ
-		tm time;
-		localtime_s(&time, &time_stamp); // ̰߳ȫ汾ͬʱʹָ
-		//tm* time = std::localtime(&time_stamp); // Ϊͨnewõģ˲ͷָ
+		memcpy(buff, cache.text, cache.length);
+		size_t length = cache.length;
+		if (flag_log_microseconds)
+		{
+			auto us = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count() % 1000000;
+			buff[length++] = '.';
+			for (int i = 5; i >= 0; i--, us /= 10) buff[length + i] = (char)('0' + us % 10);
+			length += 6;
+		}
+		return length;
+	}
 
+	// fileLOGѾڱȥĿ¼
+	LogMessage::LogMessage(const char* file, int line, LogSeverity severity)
+		: severity(severity)
+	{
 		// ʾ־ȼ
 		if (severity >= log_level)
 		{
-			message_data << "[" << log_severity_text[severity] << " "
-				<< time.tm_year + 1900 << "-" << std::setfill('0') << std::setw(2)
-				<< time.tm_mon + 1 << "-" << time.tm_mday << " "
-				<< time.tm_hour << ":" << time.tm_min << ":" << time.tm_sec << " "
-				<< _file.substr(pos).c_str() << ":" << line << "] ";
+			const std::string& severity_text = log_severity_text[severity];
+			size_t file_length = strlen(file);
+
+			char buff[128];
+			size_t length = 0;
+			buff[length++] = '[';
+			memcpy(buff + length, severity_text.data(), severity_text.size());
+			length += severity_text.size();
+			buff[length++] = ' ';
+			length += FormatTime(buff + length);
+			buff[length++] = ' ';
+			message_data.write(buff, length);
+			message_data.write(file, file_length);
+
+			buff[0] = ':';
+			char* end = std::to_chars(buff + 1, buff + sizeof(buff), line).ptr;
+			*end++ = ']';
+			*end++ = ' ';
+			message_data.write(buff, end - buff);
 		}
 	}
 
@@ -48,32 +297,56 @@ namespace chaos
 		if (severity == FATAL) abort();
 	}
 
+	bool LogMessage::IsOn(LogSeverity severity)
+	{
+		return severity >= log_level || severity == FATAL;
+	}
+
+	bool LogMessage::VerboseOn(int verbose_level)
+	{
+		return verbose_level <= flag_v && IsOn(INFO);
+	}
+
+	bool LogMessage::EveryT(std::atomic<long long>& next, double seconds)
+	{
+		long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		long long expected = next.load(std::memory_order_relaxed);
+		if (now < expected) return false;
+		return next.compare_exchange_strong(expected, now + (long long)(seconds * 1e9), std::memory_order_relaxed);
+	}
+
+	bool LogMessage::Sample(double probability)
+	{
+		// ÿ߳һxorshift64*Ҫͬ
+		static thread_local uint64_t state = 0x9E3779B97F4A7C15ULL ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		uint64_t rand = state * 0x2545F4914F6CDD1DULL;
+		return (rand >> 11) * (1.0 / 9007199254740992.0) < probability;
+	}
+
 	std::stringstream& chaos::LogMessage::Stream()
 	{
 		return message_data;
 	}
 
-	// ԺдļӦÿдļ
+	// 첽ʱֻϢУFATALҪǰ־Լд֮ŷ
 	void chaos::LogMessage::Flush()
 	{
 		if (severity >= log_level)
 		{
 			std::string message = message_data.str();
-			std::cout << message << std::endl;
-
-			if (flag_log_dir.empty())
-				return;
-
-			// ̼߳
-			mtx.lock();
-			// ־ļ
-			std::fstream log_file(flag_log_dir + "\\" + log_name, std::ios::out | std::ios::app);
-			if (log_file.is_open())
+			if (flag_log_async)
 			{
-				log_file << message << std::endl;
-				log_file.close();
+				AsyncLogger::Get().Push(std::move(message));
+				if (severity == FATAL) AsyncLogger::Get().Flush();
+				return;
 			}
-			mtx.unlock();
+
+			message.push_back('\n');
+			LogSink::Get().Write(message, true);
 		}
 	}
 
@@ -102,5 +375,10 @@ namespace chaos
 		LogMessage::log_level = level;
 	}
 
+	void FlushLogging()
+	{
+		if (flag_log_async) AsyncLogger::Get().Flush();
+	}
+
 
 } // namespace chaos
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include "core\mat.hpp"
 #include "core\core.hpp"
 
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
 
 namespace chaos
 {
@@ -51,23 +57,63 @@ namespace chaos
 		return siz[idx];
 	}
 
+	bool MatSize::operator==(const MatSize& size) const
+	{
+		return 0 == memcmp(siz, size.siz, 4 * sizeof(size_t));
+	}
+
+	bool MatSize::operator!=(const MatSize& size) const
+	{
+		return !(*this == size);
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const MatSize& size)
+	{
+		stream << "[" << size[0] << " x " << size[1] << " x " << size[2] << " x " << size[3] << "]";
+		return stream;
+	}
+
 #pragma endregion
 
 #pragma region MatStep
 	MatStep::MatStep()
 	{
-		memset(stp, 0, 3*sizeof(size_t));
+		memset(stp, 0, 4*sizeof(size_t));
+		slice_cnt = 0;
 	}
 
-	MatStep::MatStep(const MatSize& siz)
+	MatStep::MatStep(const MatSize& siz, MatLayout layout)
 	{
-		stp[0] = siz[1] * siz[2] * siz[3]; // block step: chs * h * w 
-		stp[1] = siz[2] * siz[3]; // slice step: h * w // Outer Step
-		stp[2] = siz[3]; // row step: w // Inner Step
+		switch (layout)
+		{
+		case LAYOUT_NCHW:
+			stp[0] = siz[1] * siz[2] * siz[3]; // block step: chs * h * w 
+			stp[1] = siz[2] * siz[3]; // slice step: h * w // Outer Step
+			stp[2] = siz[3]; // row step: w // Inner Step
+			stp[3] = 1;
+			break;
+		case LAYOUT_NHWC:
+			stp[0] = siz[2] * siz[3] * siz[1]; // h * w * chs
+			stp[1] = 1; // ͨ
+			stp[2] = siz[3] * siz[1]; // w * chs
+			stp[3] = siz[1]; // chs
+			break;
+		default:
+			LOG(FATAL) << "Unknown Layout";
+		}
 
 		slice_cnt = siz[0] * siz[1]; // num * chs
 	}
 
+	MatStep::MatStep(size_t num, size_t chs, size_t row, size_t col)
+	{
+		stp[0] = num;
+		stp[1] = chs;
+		stp[2] = row;
+		stp[3] = col;
+		slice_cnt = 0;
+	}
+
 
 	size_t MatStep::operator[](size_t idx) const
 	{
@@ -76,42 +122,66 @@ namespace chaos
 #pragma endregion
 
 #pragma region Mat
-	Mat::Mat() : size(MatSize()), step(MatStep()), depth(DEPTH_8U), data(nullptr), data_start(nullptr), ref_cnt(nullptr)
+	Mat::Mat() : ref_cnt(nullptr), data(nullptr), data_start(nullptr), data_end(nullptr), size(MatSize()), step(MatStep()), depth(DEPTH_8U)
 	{
 	}
 
-	Mat::Mat(const size_t width, const size_t height, const MatDepth depth) : size(1,1,height, width), step(size), depth(depth), ref_cnt(new size_t(1))
+	Mat::Mat(const size_t width, const size_t height, const MatDepth depth) : data(nullptr), data_start(nullptr), data_end(nullptr)
 	{
-		data = data_start = new uchar[size[0] * step[0] * std::powf(2, depth / 2)]();
+		Create(MatSize(1, 1, height, width), depth);
 	}
-	Mat::Mat(const std::vector<size_t> dims, const MatDepth depth) : size(dims), step(size), depth(depth), ref_cnt(new size_t(1))
+	Mat::Mat(const std::vector<size_t> dims, const MatDepth depth) : data(nullptr), data_start(nullptr), data_end(nullptr)
 	{
-		data = data_start = new uchar[size[0] * step[0] * std::powf(2, depth / 2)]();
+		Create(MatSize(dims), depth);
 	}
-	Mat::Mat(const MatSize siz, const MatDepth depth) : size(siz), step(size), depth(depth), ref_cnt(new size_t(1))
+	Mat::Mat(const MatSize siz, const MatDepth depth) : data(nullptr), data_start(nullptr), data_end(nullptr)
 	{
-		data = data_start = new uchar[size[0] * step[0] * std::powf(2, depth / 2)]();
+		Create(siz, depth);
 	}
-	Mat::Mat(const Size siz, const MatDepth depth) : size(siz), step(size), depth(depth), ref_cnt(new size_t(1))
+	Mat::Mat(const Size siz, const MatDepth depth) : data(nullptr), data_start(nullptr), data_end(nullptr)
 	{
-		data = data_start = new uchar[size[0] * step[0] * std::powf(2, depth / 2)]();
+		Create(MatSize(siz), depth);
 	}
 
-	Mat::Mat(const size_t width, const size_t height, const MatDepth, void* data) : size(1, 1, height, width), step(size), depth(depth), ref_cnt(nullptr)
+	Mat::Mat(const size_t width, const size_t height, const MatDepth depth, void* data) : ref_cnt(nullptr), size(1, 1, height, width), step(size), depth(depth)
 	{
 		this->data = data_start = (uchar*)data;
+		data_end = this->data + size[0] * step[0] * ElemSize(depth);
 	}
-	Mat::Mat(const std::vector<size_t> dims, const MatDepth, void* data) : size(dims), step(size), depth(depth), ref_cnt(nullptr)
+	Mat::Mat(const std::vector<size_t> dims, const MatDepth depth, void* data) : ref_cnt(nullptr), size(dims), step(size), depth(depth)
 	{
 		this->data = data_start = (uchar*)data;
+		data_end = this->data + size[0] * step[0] * ElemSize(depth);
 	}
-	Mat::Mat(const MatSize siz, const MatDepth, void* data) : size(siz), step(size), depth(depth), ref_cnt(nullptr)
+	Mat::Mat(const MatSize siz, const MatDepth depth, void* data, MatLayout layout) : ref_cnt(nullptr), size(siz), step(size, layout), depth(depth), layout(layout)
 	{
 		this->data = data_start = (uchar*)data;
+		data_end = this->data + size[0] * step[0] * ElemSize(depth);
 	}
-	Mat::Mat(const Size siz, const MatDepth, void* data) : size(siz), step(size), depth(depth), ref_cnt(nullptr)
+	Mat::Mat(const MatSize siz, const MatDepth depth, void* data, const MatStep& step) : ref_cnt(nullptr), size(siz), step(step), depth(depth)
 	{
+		this->step.slice_cnt = size[0] * size[1];
+		// ͨΪ1ʱΪǽŵ
+		layout = (1 == step[1] && 1 != size[1]) ? LAYOUT_NHWC : LAYOUT_NCHW;
+
+		// һԪ֮λãһάΪ0ʱǿյ
+		size_t span = 1;
+		for (int i = 0; i < 4; i++)
+		{
+			if (0 == size[i])
+			{
+				span = 0;
+				break;
+			}
+			span += (size[i] - 1) * step[i];
+		}
 		this->data = data_start = (uchar*)data;
+		data_end = this->data + span * ElemSize(depth);
+	}
+	Mat::Mat(const Size siz, const MatDepth depth, void* data) : ref_cnt(nullptr), size(siz), step(size), depth(depth)
+	{
+		this->data = data_start = (uchar*)data;
+		data_end = this->data + size[0] * step[0] * ElemSize(depth);
 	}
 
 	Mat::~Mat()
@@ -128,11 +198,14 @@ namespace chaos
 		size = mtx.size;
 		depth = mtx.depth;
 		step = mtx.step;
+		layout = mtx.layout;
 		data = mtx.data;
 		data_start = mtx.data_start;
+		data_end = mtx.data_end;
 		is_submatrix = mtx.is_submatrix;
+		allocator = mtx.allocator;
 
-		if (nullptr != ref_cnt) ++*ref_cnt;
+		if (nullptr != ref_cnt) ref_cnt->fetch_add(1, std::memory_order_relaxed);
 	}
 
 	// ȡROI
@@ -145,9 +218,12 @@ namespace chaos
 		size = mtx.size;
 		depth = mtx.depth;
 		step = mtx.step;
+		layout = mtx.layout;
 		data = mtx.data;
+		data_end = mtx.data_end;
+		allocator = mtx.allocator;
 
-		if (nullptr != ref_cnt) ++*ref_cnt;
+		if (nullptr != ref_cnt) ref_cnt->fetch_add(1, std::memory_order_relaxed);
 
 		// ޸size
 		// жroiǷͼΧ֮
@@ -155,8 +231,8 @@ namespace chaos
 		CHECK(roi.br.Inside(mat_rect) && roi.tl.Inside(mat_rect))
 			<< "The ROI is out of range.";
 
-		// roiС޸step
-		data_start = data + (roi.tl.x + roi.tl.y*size[3])*(int)std::powf(2, depth / 2);
+		// roiСstepԭMat
+		data_start = mtx.data_start + (roi.tl.x * step[3] + roi.tl.y * step[2]) * ElemSize(depth);
 		// Ȳdata_endָ
 
 		size.siz[2] = roi.size.height;
@@ -167,18 +243,52 @@ namespace chaos
 
 	Mat& Mat::operator=(const Mat& mtx)
 	{
+		if (this == &mtx) return *this;
+
+		// ݵã߹ʱǰͷ
+		if (nullptr != mtx.ref_cnt) mtx.ref_cnt->fetch_add(1, std::memory_order_relaxed);
 		Release();
 
 		ref_cnt = mtx.ref_cnt;
 		size = mtx.size;
 		depth = mtx.depth;
 		step = mtx.step;
+		layout = mtx.layout;
 		data = mtx.data;
 		data_start = mtx.data_start;
+		data_end = mtx.data_end;
 		is_submatrix = mtx.is_submatrix;
+		allocator = mtx.allocator;
+
+		return *this;
+	}
+
+	Mat::Mat(Mat&& mtx) noexcept : ref_cnt(mtx.ref_cnt), data(mtx.data), data_start(mtx.data_start), data_end(mtx.data_end),
+		size(mtx.size), step(mtx.step), depth(mtx.depth), layout(mtx.layout), is_submatrix(mtx.is_submatrix), allocator(mtx.allocator)
+	{
+		mtx.ref_cnt = nullptr;
+		mtx.data = mtx.data_start = mtx.data_end = nullptr;
+	}
+
+	Mat& Mat::operator=(Mat&& mtx) noexcept
+	{
+		if (this == &mtx) return *this;
+
+		Release();
 
 		ref_cnt = mtx.ref_cnt;
-		if (nullptr != ref_cnt) ++*ref_cnt;
+		size = mtx.size;
+		depth = mtx.depth;
+		step = mtx.step;
+		layout = mtx.layout;
+		data = mtx.data;
+		data_start = mtx.data_start;
+		data_end = mtx.data_end;
+		is_submatrix = mtx.is_submatrix;
+		allocator = mtx.allocator;
+
+		mtx.ref_cnt = nullptr;
+		mtx.data = mtx.data_start = mtx.data_end = nullptr;
 
 		return *this;
 	}
@@ -188,41 +298,130 @@ namespace chaos
 		return Mat(*this, roi);
 	}
 
-	void Mat::Release()
+	Mat Mat::Slice(size_t axis, size_t start, size_t end) const
 	{
-		if (nullptr == ref_cnt) return;
+		CHECK_LT(axis, 4) << "Axis must be in [0, 4).";
+		CHECK(start < end && end <= size[axis])
+			<< "Slice [" << start << ", " << end << ") is out of range of axis " << axis << " with size " << size[axis] << ".";
 
-		if (0 == --*ref_cnt)
-		{
-			delete[] data;
-			data = nullptr;
+		Mat view(*this);
+		view.data_start += start * step[axis] * ElemSize(depth);
+		view.size.siz[axis] = end - start;
+		view.step.slice_cnt = view.size[0] * view.size[1];
+		view.is_submatrix = true;
+		return view;
+	}
 
-			delete ref_cnt;
-			ref_cnt = nullptr;
-		}
+	Mat Mat::Batch(size_t start, size_t end) const
+	{
+		return Slice(0, start, end);
 	}
 
-	Mat Mat::Clone() const
+	Mat Mat::Channels(size_t start, size_t end) const
+	{
+		return Slice(1, start, end);
+	}
+
+	Mat Mat::Reshape(const MatSize& siz) const
+	{
+		CHECK_EQ(siz[0] * siz[1] * siz[2] * siz[3], size[0] * size[1] * size[2] * size[3])
+			<< "Can not reshape " << size << " to " << siz << ".";
+
+		// ֻаlayoutʱڴе˳ź״Ӧ
+		MatStep dense(size, layout);
+		bool reshapable = true;
+		for (int i = 0; i < 4; i++) reshapable = reshapable && (size[i] == 1 || step[i] == dense[i]);
+		CHECK(reshapable) << "Reshape requires a continuous Mat, Clone it first.";
+
+		Mat view(*this);
+		view.size = siz;
+		view.step = MatStep(siz, layout);
+		return view;
+	}
+
+	Mat Mat::Transpose() const
 	{
-		Mat mtx(size, depth);
-		
-		auto ptr = data_start;
-		auto dst = mtx.data;
-		for (size_t slice = 0; slice < mtx.step.slice_cnt; slice++)
+		Mat view(*this);
+		std::swap(view.size.siz[2], view.size.siz[3]);
+		std::swap(view.step.stp[2], view.step.stp[3]);
+		view.is_submatrix = true;
+		return view;
+	}
+
+	void Mat::Create(const MatSize siz, const MatDepth depth, bool zero_fill, MatLayout layout)
+	{
+		// ״ͬʱֱдеݣӾҲһһROI
+		// ʱԭеУlayoutֻ·Ч
+		if (nullptr != data && this->depth == depth && size == siz)
 		{
-			for (size_t row = 0; row < mtx.size[2]; row++)
+			if (zero_fill)
 			{
-				auto data = ptr + row * step[2] * (int)std::powf(2, depth / 2);
-				
-				memcpy_s(dst, mtx.size[3] * std::powf(2, depth / 2), data, mtx.size[3] * std::powf(2, depth / 2));
-
-				dst += mtx.size[3] * (int)std::powf(2, depth / 2);
+				MatRowIterator it({ this });
+				size_t row_bytes = it.length * ElemSize(depth);
+				for (size_t row = 0; row < it.rows; row++)
+					memset(it.Ptr(0, row), 0, row_bytes);
 			}
+			return;
+		}
+
+		Release();
+
+		size = siz;
+		step = MatStep(size, layout);
+		this->depth = depth;
+		this->layout = layout;
+		is_submatrix = false;
+
+		size_t bytes = size[0] * step[0] * ElemSize(depth);
+		MatAllocator* alloc = nullptr != allocator ? allocator : MatAllocator::GetDefault();
+		MatBlock* block = alloc->Allocate(bytes, zero_fill);
+		MemoryTracker::OnAllocate(block, size, depth, bytes);
+
+		ref_cnt = &block->ref_cnt;
+		data = data_start = block->Data();
+		data_end = data + bytes;
+	}
+
+	void Mat::Release()
+	{
+		// acq_rel̶֤߳ݵдͷ֮ǰɼ
+		if (nullptr != ref_cnt && 1 == ref_cnt->fetch_sub(1, std::memory_order_acq_rel))
+		{
+			MatBlock* block = MatBlock::FromData(data);
+			MemoryTracker::OnRelease(block);
+			block->allocator->Deallocate(block);
 		}
 
+		// ǷͷţǰMatٳ
+		ref_cnt = nullptr;
+		data = data_start = data_end = nullptr;
+	}
+
+	Mat Mat::Clone() const
+	{
+		Mat mtx;
+		mtx.allocator = allocator;
+		CopyTo(mtx);
 		return mtx;
 	}
 
+	bool Mat::IsContinuous() const
+	{
+		// ӲСάȿʼÿһάĲӦõڲάȵԪ
+		int order[4] = { 0, 1, 2, 3 };
+		std::stable_sort(order, order + 4, [&](int a, int b) {
+			return (size[a] == 1 ? 0 : step[a]) > (size[b] == 1 ? 0 : step[b]); });
+
+		size_t expected = 1;
+		for (int k = 3; k >= 0; k--)
+		{
+			int axis = order[k];
+			if (size[axis] == 1) continue;
+			if (step[axis] != expected) return false;
+			expected *= size[axis];
+		}
+		return true;
+	}
 
 	std::ostream & operator<<(std::ostream& stream, const Mat& mtx)
 	{
@@ -233,202 +432,372 @@ namespace chaos
 
 #pragma region MatFormatter
 
-	FormattedMat::FormattedMat(std::string pl, std::string el, const Mat& mtx, char br[7])
-	{
-		prologue = pl;
-		epilogue = el;
-		memcpy(braces, br, 7);
-
-		state = STATE_PROLOGUE;
+	// doubleܾȷʾ10
+	static const double pow10_table[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
 
-		switch (mtx.depth)
+	// дn / 10^digitsСֲdigitsλдʱnullptr
+	static char* WriteFixed(char* first, char* last, bool negative, uint64_t n, int digits)
+	{
+		if (negative)
 		{
-		case DEPTH_8U:
-			Convert = std::bind(&FormattedMat::Convert8U, this); break;
-		case DEPTH_8S:
-			Convert = std::bind(&FormattedMat::Convert8S, this); break;
-		case DEPTH_16U:
-			Convert = std::bind(&FormattedMat::Convert16U, this); break;
-		case DEPTH_16S:
-			Convert = std::bind(&FormattedMat::Convert16S, this); break;
-		case DEPTH_32S:
-			Convert = std::bind(&FormattedMat::Convert32S, this); break;
-		case DEPTH_32F:
-			Convert = std::bind(&FormattedMat::Convert32F, this); break;
-		case DEPTH_64F:
-			Convert = std::bind(&FormattedMat::Convert64F, this); break;
-		default:
-			LOG(chaos::FATAL) << "Unknown Depth Type";
+			if (first == last) return nullptr;
+			*first++ = '-';
 		}
+		uint64_t scale = (uint64_t)pow10_table[digits];
+		auto res = std::to_chars(first, last, n / scale);
+		if (res.ec != std::errc()) return nullptr;
+		if (0 == digits) return res.ptr;
+
+		char* ptr = res.ptr;
+		if (last - ptr < digits + 1) return nullptr;
+		*ptr++ = '.';
+		uint64_t frac = n % scale;
+		for (int i = digits - 1; i >= 0; i--)
+		{
+			ptr[i] = (char)('0' + frac % 10);
+			frac /= 10;
+		}
+		return ptr + digits;
+	}
 
-		this->mtx = mtx;
+	// ʽto_charsĹڶͿѧѡ϶̵ģһʱö
+	static char* WriteShortest(char* first, char* last, bool negative, uint64_t n, int digits)
+	{
+		char buff[24];
+		int len = (int)(std::to_chars(buff, buff + sizeof(buff), n).ptr - buff);
+		// ĩβ0Ч
+		int sig = len;
+		while (sig > 1 && '0' == buff[sig - 1]) sig--;
+
+		int exponent = len - 1 - digits;
+		int exp_len = std::abs(exponent) >= 100 ? 3 : 2;
+		int fixed_len = std::max(len, digits + 1) + (digits > 0 ? 1 : 0);
+		int sci_len = sig + (sig > 1 ? 1 : 0) + 2 + exp_len;
+		if (fixed_len <= sci_len) return WriteFixed(first, last, negative, n, digits);
+
+		if (last - first < sci_len + (negative ? 1 : 0)) return nullptr;
+		if (negative) *first++ = '-';
+		*first++ = buff[0];
+		if (sig > 1)
+		{
+			*first++ = '.';
+			memcpy(first, buff + 1, sig - 1);
+			first += sig - 1;
+		}
+		*first++ = 'e';
+		*first++ = exponent < 0 ? '-' : '+';
+		int e = std::abs(exponent);
+		if (3 == exp_len) *first++ = (char)('0' + e / 100);
+		*first++ = (char)('0' + e / 10 % 10);
+		*first++ = (char)('0' + e % 10);
+		return first;
+	}
 
+	// valueβfloatľ֮ǡ100...0
+	static bool FloatMidpoint(double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return (bits & ((1ull << 29) - 1)) == (1ull << 28);
 	}
 
-	const std::string FormattedMat::Next()
+	// VS2017to_charsֻ֧ȳȷظʽʱsnprintf
+	// precisionС0ʱܾȷԭʽдʱnullptr
+	template<class Type>
+	static char* FormatFloat(char* first, char* last, Type value, int precision)
 	{
-		switch (state)
-		{
-		case STATE_PROLOGUE:
-		{
-			num = 0; channel = 0;
-			state = STATE_CHANNEL_OPEN;
-			return prologue;
-		}
-		case STATE_EPILOGUE:
+		bool negative = std::signbit(value);
+		double abs = std::fabs((double)value);
+		size_t size = last - first;
+		int len = 0;
+
+		if (precision >= 0)
 		{
-			state = STATE_FINISHED;
-			return epilogue;
+			// Ŵֻһ룬е㹻ԶʱȡĽ;ȷֵһ
+			if (precision <= 18 && abs * pow10_table[precision] < 0x1p53)
+			{
+				double scaled = abs * pow10_table[precision];
+				double floor = std::floor(scaled), frac = scaled - floor;
+				if (std::fabs(frac - 0.5) > scaled * std::numeric_limits<double>::epsilon())
+				{
+					return WriteFixed(first, last, negative, (uint64_t)floor + (frac > 0.5), precision);
+				}
+			}
+			len = snprintf(first, size, "%.*f", precision, (double)value);
 		}
-		case STATE_CHANNEL_OPEN:
+		else
 		{
-			state = STATE_ROW_OPEN;
-			row = 0;
-			char brace = braces[BRACE_CHANNEL_OPEN];
-			return std::string(&brace, 1);
+			// ܾȷԭСλٵĶ10ݶܾȷʾʱdoubleĽȷģClinger
+			// С2^24doubleΪ2^53ʱܾȷʾСλټЧ٣Ҫ뵽ʮλλ
+			constexpr bool is_float = std::is_same<Type, float>::value;
+			for (int digits = 0; digits <= 22 && abs < (is_float ? 0x1p24 : 0x1p53); digits++)
+			{
+				double scaled = std::nearbyint(abs * pow10_table[digits]);
+				if (scaled >= 0x1p53) break;
+
+				double parsed = scaled / pow10_table[digits];
+				// תΪfloatʱǡfloatеϣֱܺ벻ͬ
+				if (is_float && FloatMidpoint(parsed)) break;
+				if ((Type)parsed == (Type)abs) return WriteShortest(first, last, negative, (uint64_t)scaled, digits);
+			}
+
+			// ܴ󡢺СNaNsnprintfdigits10λڵʮܾȷԭdigits10λЧֿʼλ
+			// ǹľȸͣ1λʼ
+			int min_digits = abs < std::numeric_limits<Type>::min() ? 1 : std::numeric_limits<Type>::digits10;
+			for (int digits = min_digits; digits <= std::numeric_limits<Type>::max_digits10; digits++)
+			{
+				len = snprintf(first, size, "%.*g", digits, (double)value);
+				if (len < 0 || (size_t)len >= size) break;
+
+				Type parsed;
+				if constexpr (is_float) parsed = strtof(first, nullptr);
+				else parsed = strtod(first, nullptr);
+				if (parsed == value) break;
+			}
+			// öʽʱto_charsһʽ
+			if (len > 0 && (size_t)len < size && abs < 0x1p64 && abs == std::floor(abs))
+			{
+				char buff[24];
+				int fixed_len = (int)(std::to_chars(buff, buff + sizeof(buff), (uint64_t)abs).ptr - buff) + (negative ? 1 : 0);
+				if (fixed_len <= len) return WriteFixed(first, last, negative, (uint64_t)abs, 0);
+			}
 		}
-		case STATE_CHANNEL_CLOSE:
+		// snprintfҪдβ'\0'
+		if (len < 0 || (size_t)len >= size) return nullptr;
+		return first + len;
+	}
+
+	// ֱӸʽУ˲дstream
+	// ڶϣ̳߳صջС߳ʱռùջ
+	class MatWriter
+	{
+	public:
+		MatWriter(std::ostream& stream) : stream(stream), buff(new char[capacity]) {}
+		~MatWriter() { Flush(); }
+
+		void Put(const std::string& str)
 		{
-			channel++;
-			if (channel == mtx.size[1])
+			if (str.size() > capacity - pos)
 			{
-				num++;
-				if (num == mtx.size[0])
+				Flush();
+				if (str.size() > capacity)
 				{
-					state = STATE_EPILOGUE;
-				}
-				else
-				{
-					channel = 0;
-					state = STATE_NUM_SEPARATOR;
+					stream.write(str.data(), str.size());
+					return;
 				}
 			}
-			else
+			memcpy(buff.get() + pos, str.data(), str.size());
+			pos += str.size();
+		}
+
+		template<class Type>
+		void Value(Type value, const FormattedMat::Style& style)
+		{
+			// 8λ4ַҲҪŵ
+			if (sizeof(Type) == 1 && capacity - pos < std::max(style.byte_width, (size_t)4)) Flush();
+			char* end = Convert(buff.get() + pos, buff.get() + capacity, value, style);
+			if (nullptr == end)
 			{
-				state = STATE_CHANNEL_SEPARATOR;
+				Flush();
+				end = Convert(buff.get(), buff.get() + capacity, value, style);
+				CHECK(nullptr != end) << "Formatted value exceeds " << capacity << " bytes.";
 			}
-			char brace = braces[BRACE_CHANNEL_CLOSE];
-			return std::string(&brace, 1);
+			size_t len = end - (buff.get() + pos);
+			if (sizeof(Type) == 1 && len < style.byte_width)
+			{
+				size_t pad = style.byte_width - len;
+				memmove(buff.get() + pos + pad, buff.get() + pos, len);
+				memset(buff.get() + pos, ' ', pad);
+				len += pad;
+			}
+			pos += len;
 		}
-		case STATE_CHANNEL_SEPARATOR:
+
+		void Flush()
 		{
-			char brace = braces[BRACE_CHANNEL_SEP];
-			state = STATE_CHANNEL_OPEN;
-			return std::string(&brace, 1) + "\n";
+			stream.write(buff.get(), pos);
+			pos = 0;
 		}
-		case STATE_NUM_SEPARATOR:
+
+	private:
+		template<class Type>
+		static char* Convert(char* first, char* last, Type value, const FormattedMat::Style& style)
 		{
-			char brace = braces[BRACE_NUM_SEP];
-			state = STATE_CHANNEL_OPEN;
-			return std::string(&brace, 1) + "\n\n";
+			if constexpr (IsHalf<Type>::value)
+			{
+				return Convert(first, last, (float)value, style);
+			}
+			else if constexpr (std::is_floating_point<Type>::value)
+			{
+				return FormatFloat(first, last, value, style.precision);
+			}
+			else
+			{
+				auto res = std::to_chars(first, last, (int)value);
+				return res.ec == std::errc() ? res.ptr : nullptr;
+			}
 		}
-		case STATE_ROW_OPEN:
+
+		// дʱFlush
+		static constexpr size_t capacity = 1 << 16;
+
+		std::ostream& stream;
+		size_t pos = 0;
+		std::unique_ptr<char[]> buff;
+	};
+
+	template<class Type>
+	void WriteRow(MatWriter& writer, const Type* data, size_t length, size_t stride, const FormattedMat::Style& style)
+	{
+		writer.Put(style.row_open);
+		for (size_t w = 0; w < length; w++)
 		{
-			state = STATE_VALUE;
-			col = 0;
-			char brace = braces[BRACE_ROW_OPEN];
-			if (row == 0)
-				return std::string();
-			else
-				return std::string(&brace, 1);
+			if (w > 0) writer.Put(style.value_sep);
+			writer.Value(data[w * stride], style);
 		}
-		case STATE_ROW_CLOSE:
+		writer.Put(style.row_close);
+	}
+
+	template<class Type>
+	void WriteMat(MatWriter& writer, const Mat& mtx, const FormattedMat::Style& style)
+	{
+		const size_t* siz = mtx.size.siz;
+		const size_t* stp = mtx.step.stp;
+		for (size_t n = 0; n < siz[0]; n++)
 		{
-			char brace = braces[BRACE_ROW_CLOSE];
-			return std::string(&brace, 1);
-			break;
+			if (n > 0) writer.Put(style.num_sep);
+			writer.Put(style.num_open);
+			for (size_t c = 0; c < siz[1]; c++)
+			{
+				if (c > 0) writer.Put(style.channel_sep);
+				writer.Put(style.channel_open);
+				for (size_t h = 0; h < siz[2]; h++)
+				{
+					if (h > 0) writer.Put(style.row_sep);
+					const Type* data = (const Type*)mtx.data_start + n * stp[0] + c * stp[1] + h * stp[2];
+					WriteRow(writer, data, siz[3], stp[3], style);
+				}
+				writer.Put(style.channel_close);
+			}
+			writer.Put(style.num_close);
 		}
-		case STATE_VALUE:
+	}
+
+	void FormattedMat::Write(std::ostream& stream) const
+	{
+		MatWriter writer(stream);
+		writer.Put(style.prologue);
+		if (nullptr != mtx.data_start)
 		{
-			Convert();
-			col++;
-			if (col == mtx.size[3])
-				state = STATE_LINE_SEPARATOR;
-			else
-				state = STATE_VALUE_SEPARATOR;
-			return buff;
+			DispatchDepth(mtx.depth, [&](auto tag) { WriteMat<typename decltype(tag)::Type>(writer, mtx, style); });
 		}
-		case STATE_VALUE_SEPARATOR:
+		writer.Put(style.epilogue);
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const std::shared_ptr<FormattedMat>& formatted)
+	{
+		formatted->Write(stream);
+		return stream;
+	}
+
+	class DefaultFormatter : public MatFormatter
+	{
+	public:
+		std::shared_ptr<FormattedMat> Format(const Mat& mtx) final
 		{
-			state = STATE_VALUE;
-			return ", ";
+			FormattedMat::Style style;
+			style.num_sep = ";\n\n";
+			style.channel_open = "[";
+			style.channel_sep = ",\n";
+			style.channel_close = "]";
+			style.row_sep = ";\n";
+			style.value_sep = ", ";
+			style.precision = 6;
+			style.byte_width = 3;
+			return std::make_shared<FormattedMat>(mtx, style);
 		}
-		case STATE_LINE_SEPARATOR:
+	};
+
+	class MatlabFormatter : public MatFormatter
+	{
+	public:
+		std::shared_ptr<FormattedMat> Format(const Mat& mtx) final
 		{
-			row++;
-			char brace = braces[BRACE_ROW_SEP];
-			if (row == mtx.size[2])
+			FormattedMat::Style style;
+			if (nullptr == mtx.data_start)
 			{
-				state = STATE_CHANNEL_CLOSE;
-				return std::string();
+				style.prologue = "[]";
+				return std::make_shared<FormattedMat>(mtx, style);
 			}
-			else
+
+			// ƽrows x colsͨǵ3άbatchǵ4ά
+			if (mtx.size.siz[0] > 1)
 			{
-				state = STATE_ROW_OPEN;
-				return std::string(&brace, 1) + "\n";
+				style.prologue = "cat(4, ";
+				style.epilogue = ")";
+				style.num_sep = ",\n\n";
 			}
-			
-			
-		}
-		default:
-			return std::string();
+			if (mtx.size.siz[1] > 1)
+			{
+				style.num_open = "cat(3, ";
+				style.num_close = ")";
+				style.channel_sep = ",\n";
+			}
+			style.channel_open = "[";
+			style.channel_close = "]";
+			style.row_sep = ";\n";
+			style.value_sep = ", ";
+			return std::make_shared<FormattedMat>(mtx, style);
 		}
-	}
+	};
 
-	std::ostream& operator<<(std::ostream& stream, const std::shared_ptr<FormattedMat>& formatted)
+	class PythonFormatter : public MatFormatter
 	{
-		stream << formatted->prologue;
-
-		while (formatted->state != FormattedMat::STATE_FINISHED)
+	public:
+		std::shared_ptr<FormattedMat> Format(const Mat& mtx) final
 		{
-			stream << formatted->Next();
+			FormattedMat::Style style;
+			style.prologue = "[";
+			style.epilogue = "]";
+			style.num_open = style.channel_open = style.row_open = "[";
+			style.num_close = style.channel_close = style.row_close = "]";
+			style.num_sep = ",\n\n ";
+			style.channel_sep = ",\n\n  ";
+			style.row_sep = ",\n   ";
+			style.value_sep = ", ";
+			return std::make_shared<FormattedMat>(mtx, style);
 		}
+	};
 
-		stream << formatted->epilogue;
-		return stream;
-	}
-
-	class DefaultFormatter : public MatFormatter
+	class CsvFormatter : public MatFormatter
 	{
 	public:
 		std::shared_ptr<FormattedMat> Format(const Mat& mtx) final
 		{
-			char braces[7] = { '\0', '\0', ';', '[', ']', ',', ';' };
-			return std::shared_ptr<FormattedMat>(new FormattedMat("", "", mtx, &*braces));
+			FormattedMat::Style style;
+			style.num_sep = style.channel_sep = style.row_sep = "\n";
+			style.value_sep = ",";
+			style.epilogue = nullptr == mtx.data_start ? "" : "\n";
+			return std::make_shared<FormattedMat>(mtx, style);
 		}
 	};
 
-	//class MatlabFormatter : public MatFormatter
-	//{
-	//public:
-	//	std::shared_ptr<FormattedMat> Format(const Mat& mtx) final
-	//	{
-	//		char braces[7] = { '\0', '\0', ';', '\0', '\0', '\0', '\0' };
-	//		return std::shared_ptr<FormattedMat>(new FormattedMat("", "", mtx, &*braces));
-	//	}
-	//};
-
-	//class PythonFormatter : public MatFormatter
-	//{
-	//public:
-	//	std::shared_ptr<FormattedMat> Format(const Mat& mtx) final
-	//	{
-	//		char braces[7] = { '[', ']', ',', '[', ']', '\n', '\n' };
-	//		return std::shared_ptr<FormattedMat>(new FormattedMat("[", "]", mtx, &*braces));
-	//	}
-	//};
-
 	std::shared_ptr<MatFormatter> MatFormatter::Get(MatFormatType fmt)
 	{
 		switch (fmt)
 		{
-		//case chaos::MFT_MATLAB:
-		//	return std::shared_ptr<MatFormatter>(new MatlabFormatter());
-		//case chaos::MFT_PYTHON:
-		//	return std::shared_ptr<MatFormatter>(new PythonFormatter());
-		//case chaos::MFT_DEFAULT:
+		case MFT_MATLAB:
+			return std::make_shared<MatlabFormatter>();
+		case MFT_PYTHON:
+			return std::make_shared<PythonFormatter>();
+		case MFT_CSV:
+			return std::make_shared<CsvFormatter>();
+		case MFT_DEFAULT:
 		default:
-			return std::shared_ptr<MatFormatter>(new DefaultFormatter());
+			return std::make_shared<DefaultFormatter>();
 		}
 	}
 #pragma endregion
@@ -0,0 +1,295 @@
+#include "core\memory_tracker.hpp"
+#include "core\core.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace chaos
+{
+	DEFINE_BOOL(track_memory, false, "record the shape, tag and frame of every live Mat buffer.");
+
+	static constexpr int max_depth = 16;
+
+	static std::string DepthName(int depth)
+	{
+		if (IsValidDepth((MatDepth)depth)) return GetDepthInfo((MatDepth)depth).name;
+		return "depth " + std::to_string(depth);
+	}
+
+	static std::string ShapeName(const MatSize& size, int depth)
+	{
+		std::stringstream ss;
+		ss << size[0] << "x" << size[1] << "x" << size[2] << "x" << size[3] << " " << DepthName(depth);
+		return ss.str();
+	}
+
+	class TrackedBlock
+	{
+	public:
+		MatSize size;
+		int depth;
+		size_t bytes;
+		std::string shape;
+		const char* tag;
+		size_t frame;
+		size_t sequence; // ˳
+	};
+
+	// ֻ--track_memoryʱŻõгԱmtx
+	class MemoryRegistry
+	{
+	public:
+		static MemoryRegistry& Get()
+		{
+			// ͷţȫֵMatھ̬֮ͷ
+			static MemoryRegistry* registry = new MemoryRegistry();
+			return *registry;
+		}
+
+		void Add(const std::string& key, std::map<std::string, MemoryUsage>& usages, size_t bytes)
+		{
+			MemoryUsage& usage = usages[key];
+			usage.count++;
+			usage.bytes += bytes;
+			usage.allocations++;
+			usage.peak_bytes = std::max(usage.peak_bytes, usage.bytes);
+		}
+
+		void Remove(const std::string& key, std::map<std::string, MemoryUsage>& usages, size_t bytes)
+		{
+			MemoryUsage& usage = usages[key];
+			usage.count--;
+			usage.bytes -= bytes;
+		}
+
+		std::mutex mtx;
+		std::unordered_map<MatBlock*, TrackedBlock> blocks;
+		std::map<std::string, MemoryUsage> shapes;
+		std::map<std::string, MemoryUsage> tags;
+		size_t sequence = 0;
+	};
+
+	static std::atomic<size_t> live_bytes{ 0 };
+	static std::atomic<size_t> peak_bytes{ 0 };
+	static std::atomic<size_t> live_count{ 0 };
+	static std::atomic<size_t> allocations{ 0 };
+	static std::atomic<size_t> deallocations{ 0 };
+	static std::atomic<size_t> depth_bytes[max_depth];
+	static std::atomic<size_t> depth_count[max_depth];
+	static std::atomic<size_t> depth_allocations[max_depth];
+	static std::atomic<size_t> frame{ 0 };
+
+	static thread_local const char* current_tag = nullptr;
+
+	static int DepthIndex(int depth)
+	{
+		return depth >= 0 && depth < max_depth ? depth : max_depth - 1;
+	}
+
+	bool MemoryTracker::IsEnabled()
+	{
+		return flag_track_memory;
+	}
+
+	void MemoryTracker::SetEnabled(bool enabled)
+	{
+		flag_track_memory = enabled;
+	}
+
+	size_t MemoryTracker::LiveBytes()
+	{
+		return live_bytes.load(std::memory_order_relaxed);
+	}
+
+	size_t MemoryTracker::PeakBytes()
+	{
+		return peak_bytes.load(std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::ResetPeak()
+	{
+		peak_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	size_t MemoryTracker::NextFrame()
+	{
+		return ++frame;
+	}
+
+	size_t MemoryTracker::Frame()
+	{
+		return frame.load(std::memory_order_relaxed);
+	}
+
+	const char* MemoryTracker::SetTag(const char* name)
+	{
+		const char* previous = current_tag;
+		current_tag = name;
+		return previous;
+	}
+
+	void MemoryTracker::OnAllocate(MatBlock* block, const MatSize& size, MatDepth depth, size_t bytes)
+	{
+		block->bytes = bytes;
+		block->depth = depth;
+		block->tracked = false;
+
+		size_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		size_t peak = peak_bytes.load(std::memory_order_relaxed);
+		while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+		live_count.fetch_add(1, std::memory_order_relaxed);
+		allocations.fetch_add(1, std::memory_order_relaxed);
+
+		int idx = DepthIndex(depth);
+		depth_bytes[idx].fetch_add(bytes, std::memory_order_relaxed);
+		depth_count[idx].fetch_add(1, std::memory_order_relaxed);
+		depth_allocations[idx].fetch_add(1, std::memory_order_relaxed);
+
+		if (!flag_track_memory) return;
+
+		const char* tag = nullptr != current_tag ? current_tag : "untagged";
+		std::string shape = ShapeName(size, depth);
+		MemoryRegistry& registry = MemoryRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mtx);
+		registry.Add(shape, registry.shapes, bytes);
+		registry.Add(tag, registry.tags, bytes);
+		registry.blocks[block] = { size, depth, bytes, std::move(shape), tag, frame.load(std::memory_order_relaxed), registry.sequence++ };
+		block->tracked = true;
+	}
+
+	void MemoryTracker::OnRelease(MatBlock* block)
+	{
+		size_t bytes = block->bytes;
+		live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+		live_count.fetch_sub(1, std::memory_order_relaxed);
+		deallocations.fetch_add(1, std::memory_order_relaxed);
+
+		int idx = DepthIndex(block->depth);
+		depth_bytes[idx].fetch_sub(bytes, std::memory_order_relaxed);
+		depth_count[idx].fetch_sub(1, std::memory_order_relaxed);
+
+		// ر--track_memory֮֮ǰ¼ĿȻҪƳ
+		if (!block->tracked) return;
+
+		MemoryRegistry& registry = MemoryRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mtx);
+		auto it = registry.blocks.find(block);
+		if (it == registry.blocks.end()) return;
+		registry.Remove(it->second.shape, registry.shapes, bytes);
+		registry.Remove(it->second.tag, registry.tags, bytes);
+		registry.blocks.erase(it);
+	}
+
+	MemoryStats MemoryTracker::Stats()
+	{
+		MemoryStats stats;
+		stats.live_bytes = live_bytes.load(std::memory_order_relaxed);
+		stats.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+		stats.live_count = live_count.load(std::memory_order_relaxed);
+		stats.allocations = allocations.load(std::memory_order_relaxed);
+		stats.deallocations = deallocations.load(std::memory_order_relaxed);
+
+		for (int i = 0; i < max_depth; i++)
+		{
+			size_t count = depth_allocations[i].load(std::memory_order_relaxed);
+			if (0 == count) continue;
+			MemoryUsage& usage = stats.depths[(MatDepth)i];
+			usage.allocations = count;
+			usage.count = depth_count[i].load(std::memory_order_relaxed);
+			usage.bytes = depth_bytes[i].load(std::memory_order_relaxed);
+		}
+
+		MemoryRegistry& registry = MemoryRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mtx);
+		stats.shapes = registry.shapes;
+		stats.tags = registry.tags;
+		return stats;
+	}
+
+	std::vector<MemoryRecord> MemoryTracker::LiveAllocations(size_t before_frame)
+	{
+		std::vector<std::pair<size_t, MemoryRecord>> live;
+		{
+			MemoryRegistry& registry = MemoryRegistry::Get();
+			std::lock_guard<std::mutex> lock(registry.mtx);
+			for (auto& item : registry.blocks)
+			{
+				const TrackedBlock& block = item.second;
+				if (block.frame >= before_frame) continue;
+
+				MemoryRecord record;
+				record.size = block.size;
+				record.depth = (MatDepth)block.depth;
+				record.bytes = block.bytes;
+				record.tag = block.tag;
+				record.frame = block.frame;
+				live.emplace_back(block.sequence, record);
+			}
+		}
+
+		std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		std::vector<MemoryRecord> records;
+		for (auto& item : live) records.push_back(item.second);
+		return records;
+	}
+
+	void MemoryTracker::Dump(size_t max_shapes)
+	{
+		MemoryStats stats = Stats();
+		LOG(INFO) << "Mat memory: live " << stats.live_bytes << " bytes in " << stats.live_count << " blocks, peak "
+			<< stats.peak_bytes << " bytes, " << stats.allocations << " allocations, " << stats.deallocations << " deallocations";
+		for (auto& item : stats.depths)
+		{
+			LOG(INFO) << "  depth " << std::left << std::setw(24) << DepthName(item.first) << std::right
+				<< " live: " << std::setw(12) << item.second.bytes << " bytes in " << std::setw(6) << item.second.count
+				<< " blocks, allocations: " << item.second.allocations;
+		}
+
+		std::vector<std::pair<std::string, MemoryUsage>> shapes(stats.shapes.begin(), stats.shapes.end());
+		std::sort(shapes.begin(), shapes.end(), [](const auto& a, const auto& b) {
+			return a.second.bytes != b.second.bytes ? a.second.bytes > b.second.bytes : a.second.peak_bytes > b.second.peak_bytes; });
+		if (shapes.size() > max_shapes) shapes.resize(max_shapes);
+		for (auto& item : shapes)
+		{
+			LOG(INFO) << "  shape " << std::left << std::setw(24) << item.first << std::right
+				<< " live: " << std::setw(12) << item.second.bytes << " bytes in " << std::setw(6) << item.second.count
+				<< " blocks, peak: " << item.second.peak_bytes << " bytes, allocations: " << item.second.allocations;
+		}
+		for (auto& item : stats.tags)
+		{
+			LOG(INFO) << "  tag   " << std::left << std::setw(24) << item.first << std::right
+				<< " live: " << std::setw(12) << item.second.bytes << " bytes in " << std::setw(6) << item.second.count
+				<< " blocks, peak: " << item.second.peak_bytes << " bytes, allocations: " << item.second.allocations;
+		}
+	}
+
+	void MemoryTracker::DumpLive(size_t before_frame, size_t max_records)
+	{
+		std::vector<MemoryRecord> records = LiveAllocations(before_frame);
+		if (records.empty()) return;
+
+		size_t bytes = 0;
+		for (auto& record : records) bytes += record.bytes;
+		if (before_frame == (size_t)-1) LOG(WARNING) << records.size() << " Mat buffers (" << bytes << " bytes) are still alive";
+		else LOG(WARNING) << records.size() << " Mat buffers (" << bytes << " bytes) allocated before frame " << before_frame << " are still alive";
+		for (size_t i = 0; i < records.size() && i < max_records; i++) LOG(WARNING) << "  " << records[i];
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const MemoryRecord& record)
+	{
+		stream << ShapeName(record.size, record.depth) << ", " << record.bytes << " bytes, tag: " << record.tag << ", frame: " << record.frame;
+		return stream;
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const MemoryStats& stats)
+	{
+		stream << "[live: " << stats.live_bytes << " bytes in " << stats.live_count << " blocks, peak: " << stats.peak_bytes
+			<< " bytes, allocations: " << stats.allocations << ", deallocations: " << stats.deallocations << "]";
+		return stream;
+	}
+
+} // namespace chaos
@@ -0,0 +1,228 @@
+#include "core\parallel.hpp"
+#include "core\core.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace chaos
+{
+	DEFINE_INT(num_threads, 0, "number of threads used by ParallelFor, 0 means all cores.");
+
+	// ǰ߳ǷִвǶ׵ParallelForֱӴִУȴԼ
+	static thread_local bool inside_pool = false;
+
+	// ÿ߳ԼУӶβȡԼ񣬿ʱеĶȡ
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(size_t threads)
+		{
+			for (size_t i = 0; i < threads; i++) queues.push_back(std::make_unique<Queue>());
+			// 0ڵParallelFor߳
+			for (size_t i = 1; i < threads; i++) workers.emplace_back(&ThreadPool::Work, this, i);
+		}
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(wake_mtx);
+				stop = true;
+			}
+			wake_cv.notify_all();
+			for (auto& worker : workers) worker.join();
+		}
+
+		size_t Size() const { return queues.size(); }
+
+		void Run(const Range& range, size_t chunks, const std::function<void(const Range&)>& body)
+		{
+			Job job;
+			job.body = &body;
+			job.remaining = chunks;
+
+			{
+				std::lock_guard<std::mutex> lock(wake_mtx);
+				pending += chunks;
+			}
+			size_t total = range.Size();
+			for (size_t i = 0; i < chunks; i++)
+			{
+				Range part(range.begin + total * i / chunks, range.begin + total * (i + 1) / chunks);
+				Queue& queue = *queues[i % queues.size()];
+				std::lock_guard<std::mutex> lock(queue.mtx);
+				queue.tasks.push_back({ &job, part });
+			}
+			wake_cv.notify_all();
+
+			// ߳ҲִУֱεȫ
+			bool nested = inside_pool;
+			inside_pool = true;
+			while (job.remaining.load(std::memory_order_acquire) > 0)
+			{
+				Task task;
+				if (Pop(0, task)) Execute(task);
+				else std::this_thread::yield();
+			}
+			inside_pool = nested;
+		}
+
+	private:
+		struct Job
+		{
+			const std::function<void(const Range&)>* body;
+			std::atomic<size_t> remaining;
+		};
+
+		struct Task
+		{
+			Job* job;
+			Range range;
+		};
+
+		struct Queue
+		{
+			std::mutex mtx;
+			std::deque<Task> tasks;
+		};
+
+		bool Pop(size_t self, Task& task)
+		{
+			for (size_t i = 0; i < queues.size(); i++)
+			{
+				Queue& queue = *queues[(self + i) % queues.size()];
+				std::lock_guard<std::mutex> lock(queue.mtx);
+				if (queue.tasks.empty()) continue;
+
+				if (i == 0)
+				{
+					// ԼĶкȳݻڻ
+					task = queue.tasks.back();
+					queue.tasks.pop_back();
+				}
+				else
+				{
+					task = queue.tasks.front();
+					queue.tasks.pop_front();
+				}
+				pending--;
+				return true;
+			}
+			return false;
+		}
+
+		void Execute(const Task& task)
+		{
+			(*task.job->body)(task.range);
+			task.job->remaining.fetch_sub(1, std::memory_order_release);
+		}
+
+		void Work(size_t self)
+		{
+			inside_pool = true;
+			while (true)
+			{
+				Task task;
+				if (Pop(self, task))
+				{
+					Execute(task);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(wake_mtx);
+				wake_cv.wait(lock, [this]() { return stop || pending > 0; });
+				if (stop && pending == 0) return;
+			}
+		}
+
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> workers;
+
+		std::mutex wake_mtx;
+		std::condition_variable wake_cv;
+		std::atomic<size_t> pending{ 0 };
+		bool stop = false;
+	};
+
+	static std::mutex pool_mtx;
+	static std::unique_ptr<ThreadPool> pool;
+
+	// һʹʱŴʱвѾ
+	static ThreadPool& GetPool()
+	{
+		std::lock_guard<std::mutex> lock(pool_mtx);
+		if (!pool)
+		{
+			size_t threads = flag_num_threads > 0 ? flag_num_threads : std::thread::hardware_concurrency();
+			pool = std::make_unique<ThreadPool>(std::max((size_t)1, threads));
+		}
+		return *pool;
+	}
+
+	size_t GetNumThreads()
+	{
+		return GetPool().Size();
+	}
+
+	void SetNumThreads(size_t threads)
+	{
+		std::lock_guard<std::mutex> lock(pool_mtx);
+		pool.reset();
+		pool = std::make_unique<ThreadPool>(std::max((size_t)1, threads));
+	}
+
+	void ParallelFor(const Range& range, size_t grain, const std::function<void(const Range&)>& body)
+	{
+		if (range.Empty()) return;
+
+		grain = std::max((size_t)1, grain);
+		size_t chunks = range.Size() / grain;
+		if (inside_pool || chunks <= 1)
+		{
+			body(range);
+			return;
+		}
+
+		ThreadPool& threads = GetPool();
+		if (threads.Size() == 1)
+		{
+			body(range);
+			return;
+		}
+		// ÿ̷ֵ߳Σȡ
+		threads.Run(range, std::min(chunks, threads.Size() * 4), body);
+	}
+
+	void ParallelForSlices(const Mat& mtx, const std::function<void(const Range& slices)>& body)
+	{
+		ParallelFor(Range(0, mtx.size[0] * mtx.size[1]), 1, body);
+	}
+
+	void ParallelForRows(const Mat& mtx, size_t grain, const std::function<void(const Range& rows)>& body)
+	{
+		ParallelFor(Range(0, mtx.size[0] * mtx.size[1] * mtx.size[2]), grain, body);
+	}
+
+	void ParallelForTiles(const Mat& mtx, const Size& tile, const std::function<void(size_t slice, const Rect& roi)>& body)
+	{
+		CHECK(tile.width > 0 && tile.height > 0) << "Tile size must be positive.";
+
+		int rows = (int)mtx.size[2], cols = (int)mtx.size[3];
+		size_t tiles_x = (cols + tile.width - 1) / tile.width;
+		size_t tiles_y = (rows + tile.height - 1) / tile.height;
+		size_t tiles = tiles_x * tiles_y;
+
+		ParallelFor(Range(0, mtx.size[0] * mtx.size[1] * tiles), 1, [&](const Range& range) {
+			for (size_t i = range.begin; i < range.end; i++)
+			{
+				size_t slice = i / tiles;
+				int x = (int)(i % tiles % tiles_x) * tile.width;
+				int y = (int)(i % tiles / tiles_x) * tile.height;
+				body(slice, Rect(x, y, std::min(tile.width, cols - x), std::min(tile.height, rows - y)));
+			}
+		});
+	}
+
+} // namespace chaos
@@ -0,0 +1,341 @@
+#include "core\persistence.hpp"
+#include "core\core.hpp"
+
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chaos
+{
+	static constexpr char mat_file_magic[8] = { 'C', 'H', 'A', 'O', 'S', 'M', 'A', 'T' };
+	static constexpr uint32_t mat_file_version = 1;
+	static constexpr size_t mat_file_align = 64;
+	static constexpr size_t max_name_length = 63;
+
+	// ļеĽṹ64ֽڵݿƫư64ֽڶ
+	struct MatFileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t count; // Matĸ
+		uint64_t file_size;
+		uint64_t reserved[5];
+	};
+	static_assert(sizeof(MatFileHeader) == 64, "MatFileHeader must be 64 bytes");
+
+	struct MatFileEntry
+	{
+		char name[max_name_length + 1];
+		uint64_t size[4]; // NCHW
+		int32_t depth;
+		int32_t layout;
+		uint64_t offset; // ļʼƫ
+		uint64_t bytes;
+		uint64_t checksum;
+	};
+	static_assert(sizeof(MatFileEntry) == 128, "MatFileEntry must be 128 bytes");
+
+	static size_t AlignUp(size_t value)
+	{
+		return (value + mat_file_align - 1) / mat_file_align * mat_file_align;
+	}
+
+	// xxHash64Уͣ4·Уÿδ32ֽ
+	static uint64_t Checksum(const uchar* data, size_t bytes)
+	{
+		constexpr uint64_t p1 = 0x9E3779B185EBCA87ULL;
+		constexpr uint64_t p2 = 0xC2B2AE3D27D4EB4FULL;
+		constexpr uint64_t p3 = 0x165667B19E3779F9ULL;
+		constexpr uint64_t p4 = 0x85EBCA77C2B2AE63ULL;
+		constexpr uint64_t p5 = 0x27D4EB2F165667C5ULL;
+		auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+		auto round = [&](uint64_t acc, uint64_t input) { return rotl(acc + input * p2, 31) * p1; };
+		auto merge = [&](uint64_t acc, uint64_t val) { return (acc ^ round(0, val)) * p1 + p4; };
+		auto read64 = [](const uchar* ptr) { uint64_t val; memcpy(&val, ptr, 8); return val; };
+
+		const uchar* end = data + bytes;
+		uint64_t hash;
+		if (bytes >= 32)
+		{
+			uint64_t v1 = p1 + p2, v2 = p2, v3 = 0, v4 = 0 - p1;
+			for (; data + 32 <= end; data += 32)
+			{
+				v1 = round(v1, read64(data));
+				v2 = round(v2, read64(data + 8));
+				v3 = round(v3, read64(data + 16));
+				v4 = round(v4, read64(data + 24));
+			}
+			hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+			hash = merge(merge(merge(merge(hash, v1), v2), v3), v4);
+		}
+		else
+		{
+			hash = p5;
+		}
+
+		hash += bytes;
+		for (; data + 8 <= end; data += 8) hash = rotl(hash ^ round(0, read64(data)), 27) * p1 + p4;
+		for (; data < end; data++) hash = rotl(hash ^ (*data * p5), 11) * p1;
+
+		hash ^= hash >> 33;
+		hash *= p2;
+		hash ^= hash >> 29;
+		hash *= p3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	// layoutʱֱд룬ȿһ
+	static Mat Dense(const Mat& mtx)
+	{
+		MatStep dense(mtx.size, mtx.layout);
+		for (int i = 0; i < 4; i++)
+		{
+			if (mtx.size.siz[i] > 1 && mtx.step.stp[i] != dense.stp[i]) return mtx.Clone();
+		}
+		return mtx;
+	}
+
+	// ļ𻵻򱻴۸ģݱļڣС״һ
+	static void CheckEntry(const MatFileEntry& entry, size_t length, const std::string& file)
+	{
+		CHECK(IsValidDepth((MatDepth)entry.depth)) << "Invalid depth " << entry.depth << " in " << file;
+		CHECK(LAYOUT_NCHW == entry.layout || LAYOUT_NHWC == entry.layout) << "Invalid layout " << entry.layout << " in " << file;
+		CHECK_EQ(entry.offset % mat_file_align, 0) << "Misaligned data in " << file;
+		// ֿȽϣoffset + bytes
+		CHECK(entry.offset <= length && entry.bytes <= length - entry.offset) << "Truncated Mat file " << file;
+
+		// Mat
+		if (0 == entry.bytes) return;
+		uint64_t expected = ElemSize((MatDepth)entry.depth);
+		for (int i = 0; i < 4; i++)
+		{
+			CHECK(0 == entry.size[i] || expected <= UINT64_MAX / entry.size[i]) << "Invalid Mat size in " << file;
+			expected *= entry.size[i];
+		}
+		CHECK_EQ(entry.bytes, expected) << "Data size does not match the Mat size in " << file;
+	}
+
+	static MatFileHeader ReadHeader(std::istream& stream, const std::string& file, std::vector<MatFileEntry>& entries, size_t& length)
+	{
+		stream.seekg(0, std::ios::end);
+		length = (size_t)stream.tellg();
+		stream.seekg(0, std::ios::beg);
+
+		MatFileHeader header;
+		stream.read((char*)&header, sizeof(header));
+		CHECK(stream && 0 == memcmp(header.magic, mat_file_magic, sizeof(mat_file_magic))) << file << " is not a Mat file.";
+		CHECK_EQ(header.version, mat_file_version) << "Unsupported Mat file version in " << file;
+		// ȰļСٷ
+		CHECK_LE(header.count, (length - sizeof(MatFileHeader)) / sizeof(MatFileEntry)) << "Truncated Mat file " << file;
+
+		entries.resize(header.count);
+		stream.read((char*)entries.data(), header.count * sizeof(MatFileEntry));
+		CHECK(stream) << "Truncated Mat file " << file;
+		return header;
+	}
+
+	static MatSize EntrySize(const MatFileEntry& entry)
+	{
+		return MatSize((size_t)entry.size[0], (size_t)entry.size[1], (size_t)entry.size[2], (size_t)entry.size[3]);
+	}
+
+	void SaveMat(const std::string& file, const Mat& mtx)
+	{
+		SaveMats(file, { { std::string(), mtx } });
+	}
+
+	Mat LoadMat(const std::string& file)
+	{
+		std::ifstream stream(file, std::ios::binary);
+		CHECK(stream.is_open()) << "Can not open " << file;
+
+		std::vector<MatFileEntry> entries;
+		size_t length;
+		ReadHeader(stream, file, entries, length);
+		CHECK(!entries.empty()) << file << " contains no Mat.";
+
+		const MatFileEntry& entry = entries.front();
+		CheckEntry(entry, length, file);
+		Mat mtx;
+		if (0 == entry.bytes) return mtx;
+		mtx.Create(EntrySize(entry), (MatDepth)entry.depth, false, (MatLayout)entry.layout);
+		stream.seekg(entry.offset);
+		stream.read((char*)mtx.data_start, entry.bytes);
+		CHECK(stream) << "Truncated Mat file " << file;
+		CHECK_EQ(Checksum(mtx.data_start, entry.bytes), entry.checksum) << "Checksum mismatch in " << file;
+		return mtx;
+	}
+
+	void SaveMats(const std::string& file, const std::map<std::string, Mat>& mats)
+	{
+		std::vector<Mat> dense;
+		std::vector<MatFileEntry> entries;
+		size_t offset = AlignUp(sizeof(MatFileHeader) + mats.size() * sizeof(MatFileEntry));
+		for (auto& mat : mats)
+		{
+			const std::string& name = mat.first;
+			CHECK_LE(name.size(), max_name_length) << "Mat name is too long: " << name;
+
+			dense.push_back(Dense(mat.second));
+			const Mat& mtx = dense.back();
+
+			MatFileEntry entry;
+			memset(&entry, 0, sizeof(entry));
+			memcpy(entry.name, name.data(), name.size());
+			for (int i = 0; i < 4; i++) entry.size[i] = mtx.size.siz[i];
+			entry.depth = mtx.depth;
+			entry.layout = mtx.layout;
+			entry.offset = offset;
+			if (nullptr != mtx.data_start)
+				entry.bytes = mtx.size.siz[0] * mtx.size.siz[1] * mtx.size.siz[2] * mtx.size.siz[3] * ElemSize(mtx.depth);
+			entry.checksum = Checksum(mtx.data_start, entry.bytes);
+			entries.push_back(entry);
+
+			offset = AlignUp(offset + entry.bytes);
+		}
+
+		MatFileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, mat_file_magic, sizeof(mat_file_magic));
+		header.version = mat_file_version;
+		header.count = (uint32_t)entries.size();
+		header.file_size = offset;
+
+		std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+		CHECK(stream.is_open()) << "Can not open " << file;
+
+		static const char zeros[mat_file_align] = { 0 };
+		stream.write((const char*)&header, sizeof(header));
+		stream.write((const char*)entries.data(), entries.size() * sizeof(MatFileEntry));
+		size_t pos = sizeof(header) + entries.size() * sizeof(MatFileEntry);
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			stream.write(zeros, entries[i].offset - pos);
+			stream.write((const char*)dense[i].data_start, entries[i].bytes);
+			pos = entries[i].offset + entries[i].bytes;
+		}
+		stream.write(zeros, offset - pos);
+		CHECK(stream) << "Failed to write " << file;
+	}
+
+	std::map<std::string, Mat> LoadMats(const std::string& file)
+	{
+		MappedMatFile mapped(file);
+		std::map<std::string, Mat> mats;
+		for (auto& name : mapped.Names())
+		{
+			CHECK(mapped.Verify(name)) << "Checksum mismatch for " << name << " in " << file;
+			Mat mtx = mapped.Get(name);
+			mats[name] = nullptr == mtx.data ? mtx : mtx.Clone();
+		}
+		return mats;
+	}
+
+#pragma region MappedMatFile
+
+	MappedMatFile::MappedMatFile(const std::string& file, bool verify) : file(file)
+	{
+#ifdef _WIN32
+		HANDLE fd = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		CHECK(INVALID_HANDLE_VALUE != fd) << "Can not open " << file;
+		LARGE_INTEGER file_size;
+		GetFileSizeEx(fd, &file_size);
+		length = (size_t)file_size.QuadPart;
+		if (length > 0)
+		{
+			handle = CreateFileMappingA(fd, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+			CHECK(nullptr != handle) << "Can not map " << file;
+			// дʱƣMat޸ֻڱ̿ɼ
+			base = (uchar*)MapViewOfFile(handle, FILE_MAP_COPY, 0, 0, 0);
+			CHECK(nullptr != base) << "Can not map " << file;
+		}
+		CloseHandle(fd);
+#else
+		int fd = open(file.c_str(), O_RDONLY);
+		CHECK_GE(fd, 0) << "Can not open " << file;
+		struct stat st;
+		fstat(fd, &st);
+		length = (size_t)st.st_size;
+		if (length > 0)
+		{
+			void* addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			CHECK(MAP_FAILED != addr) << "Can not map " << file;
+			base = (uchar*)addr;
+		}
+		close(fd);
+#endif
+
+		CHECK_GE(length, sizeof(MatFileHeader)) << file << " is not a Mat file.";
+		const MatFileHeader* header = (const MatFileHeader*)base;
+		CHECK(0 == memcmp(header->magic, mat_file_magic, sizeof(mat_file_magic))) << file << " is not a Mat file.";
+		CHECK_EQ(header->version, mat_file_version) << "Unsupported Mat file version in " << file;
+		CHECK_LE(header->count, (length - sizeof(MatFileHeader)) / sizeof(MatFileEntry)) << "Truncated Mat file " << file;
+
+		const MatFileEntry* entry = (const MatFileEntry*)(header + 1);
+		for (uint32_t i = 0; i < header->count; i++, entry++)
+		{
+			CheckEntry(*entry, length, file);
+
+			std::string name(entry->name, strnlen(entry->name, sizeof(entry->name)));
+			entries[name] = { EntrySize(*entry), (MatDepth)entry->depth, (MatLayout)entry->layout,
+				(size_t)entry->offset, (size_t)entry->bytes, entry->checksum };
+			if (verify) CHECK(Verify(name)) << "Checksum mismatch for " << name << " in " << file;
+		}
+	}
+
+	MappedMatFile::~MappedMatFile()
+	{
+#ifdef _WIN32
+		if (nullptr != base) UnmapViewOfFile(base);
+		if (nullptr != handle) CloseHandle(handle);
+#else
+		if (nullptr != base) munmap(base, length);
+#endif
+	}
+
+	const MappedMatFile::Entry& MappedMatFile::Find(const std::string& name) const
+	{
+		auto it = entries.find(name);
+		CHECK(it != entries.end()) << "No Mat named '" << name << "' in " << file;
+		return it->second;
+	}
+
+	Mat MappedMatFile::Get(const std::string& name) const
+	{
+		const Entry& entry = Find(name);
+		// ǿMat
+		if (0 == entry.bytes) return Mat();
+		return Mat(entry.size, entry.depth, base + entry.offset, entry.layout);
+	}
+
+	bool MappedMatFile::Contains(const std::string& name) const
+	{
+		return entries.find(name) != entries.end();
+	}
+
+	std::vector<std::string> MappedMatFile::Names() const
+	{
+		std::vector<std::string> names;
+		for (auto& entry : entries) names.push_back(entry.first);
+		return names;
+	}
+
+	bool MappedMatFile::Verify(const std::string& name) const
+	{
+		const Entry& entry = Find(name);
+		return Checksum(base + entry.offset, entry.bytes) == entry.checksum;
+	}
+
+#pragma endregion
+
+} // namespace chaos
@@ -0,0 +1,257 @@
+#include "core\profiler.hpp"
+#include "core\core.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+
+namespace chaos
+{
+	DEFINE_BOOL(profile, false, "record the time spent in CHAOS_PROFILE_SCOPE blocks.");
+	DEFINE_INT(profile_max_events, 1 << 20, "maximum number of profile events kept per thread, 0 means no limit.");
+
+	// traceеʱʱ̣ڼʱʼκĿʼʱ
+	static const long long profile_epoch = Profiler::Now();
+
+	class ProfileEvent
+	{
+	public:
+		const char* name;
+		long long begin;
+		long long end;
+	};
+
+	// ̵߳¼ֻи̻߳д
+	// ¼ڹ̶СĿУһͲƶдcountȡʱҪ
+	class ProfileBuffer
+	{
+	public:
+		static constexpr size_t chunk_size = 4096;
+
+		class Chunk
+		{
+		public:
+			ProfileEvent events[chunk_size];
+			std::atomic<size_t> count{ 0 };
+			std::atomic<Chunk*> next{ nullptr };
+		};
+
+		ProfileBuffer(uint32_t thread) : head(new Chunk), tail(head), thread(thread) {}
+		~ProfileBuffer()
+		{
+			while (nullptr != head)
+			{
+				Chunk* next = head->next.load();
+				delete head;
+				head = next;
+			}
+		}
+
+		void Push(const ProfileEvent& event)
+		{
+			size_t count = tail->count.load(std::memory_order_relaxed);
+			if (count == chunk_size)
+			{
+				// ﵽ޺µ¼ֻ
+				size_t limit = (size_t)std::max(flag_profile_max_events, 0);
+				if (0 != limit && chunks * chunk_size >= limit)
+				{
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				Chunk* chunk = new Chunk;
+				tail->next.store(chunk, std::memory_order_release);
+				tail = chunk;
+				chunks++;
+				count = 0;
+			}
+			tail->events[count] = event;
+			tail->count.store(count + 1, std::memory_order_release);
+		}
+
+		template<class Func>
+		void ForEach(Func func) const
+		{
+			for (Chunk* chunk = head; nullptr != chunk; chunk = chunk->next.load(std::memory_order_acquire))
+			{
+				size_t count = chunk->count.load(std::memory_order_acquire);
+				for (size_t i = (chunk == head ? skip : 0); i < count; i++) func(chunk->events[i]);
+			}
+		}
+
+		// дֻ߳tailѾһĿͷ
+		void Clear()
+		{
+			Chunk* next;
+			while (nullptr != (next = head->next.load(std::memory_order_acquire)))
+			{
+				delete head;
+				head = next;
+			}
+			skip = head->count.load(std::memory_order_acquire);
+			chunks = 1;
+			dropped = 0;
+		}
+
+		Chunk* head; // ֻڳregistryʱ
+		Chunk* tail; // ֻд̷߳
+		size_t chunks = 1; // ֻд̺߳Clear
+		size_t skip = 0; // headбClear¼
+		std::atomic<size_t> dropped{ 0 }; // --profile_max_events¼
+		uint32_t thread;
+	};
+
+	// ߳˳󻺳Ȼֱ̽
+	class ProfileRegistry
+	{
+	public:
+		// ̬ʱ̳߳зܻ߳̿дԼĻ
+		static ProfileRegistry& Get()
+		{
+			static ProfileRegistry* registry = new ProfileRegistry;
+			return *registry;
+		}
+
+		ProfileBuffer* NewBuffer()
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			buffers.push_back(new ProfileBuffer((uint32_t)buffers.size()));
+			return buffers.back();
+		}
+
+		std::mutex mtx;
+		std::vector<ProfileBuffer*> buffers;
+	};
+
+	static ProfileBuffer& LocalBuffer()
+	{
+		thread_local ProfileBuffer* buffer = ProfileRegistry::Get().NewBuffer();
+		return *buffer;
+	}
+
+	bool Profiler::IsEnabled()
+	{
+		return flag_profile;
+	}
+
+	void Profiler::SetEnabled(bool enabled)
+	{
+		flag_profile = enabled;
+	}
+
+	long long Profiler::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Profiler::Record(const char* name, long long begin, long long end)
+	{
+		LocalBuffer().Push({ name, begin, end });
+	}
+
+	std::vector<ProfileStats> Profiler::Stats()
+	{
+		// ͬһڲͬı뵥Ԫпǲָͬ룬ݻ
+		std::map<std::string, std::vector<long long>> durations;
+		{
+			ProfileRegistry& registry = ProfileRegistry::Get();
+			std::lock_guard<std::mutex> lock(registry.mtx);
+			std::map<const char*, std::vector<long long>*> cache;
+			for (auto buffer : registry.buffers)
+			{
+				buffer->ForEach([&](const ProfileEvent& event) {
+					auto& list = cache[event.name];
+					if (nullptr == list) list = &durations[event.name];
+					list->push_back(event.end - event.begin);
+				});
+			}
+		}
+
+		std::vector<ProfileStats> stats;
+		for (auto& item : durations)
+		{
+			std::vector<long long>& list = item.second;
+			std::sort(list.begin(), list.end());
+
+			ProfileStats stat;
+			stat.name = item.first;
+			stat.count = list.size();
+			for (auto duration : list) stat.total += duration;
+			stat.mean = stat.total / stat.count;
+			stat.p50 = (double)list[(list.size() - 1) / 2];
+			stat.p99 = (double)list[(list.size() - 1) * 99 / 100];
+			stat.max = (double)list.back();
+			stats.push_back(stat);
+		}
+		std::sort(stats.begin(), stats.end(), [](const ProfileStats& a, const ProfileStats& b) { return a.total > b.total; });
+		return stats;
+	}
+
+	void Profiler::Report()
+	{
+		for (auto& stat : Stats()) LOG(INFO) << stat;
+		size_t dropped = DroppedEvents();
+		if (0 != dropped) LOG(WARNING) << dropped << " profile events were dropped, raise --profile_max_events to keep them.";
+	}
+
+	size_t Profiler::DroppedEvents()
+	{
+		ProfileRegistry& registry = ProfileRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mtx);
+		size_t dropped = 0;
+		for (auto buffer : registry.buffers) dropped += buffer->dropped.load(std::memory_order_relaxed);
+		return dropped;
+	}
+
+	void Profiler::ExportChromeTrace(const std::string& file)
+	{
+		std::ofstream stream(file);
+		CHECK(stream.is_open()) << "Can not open " << file;
+
+		ProfileRegistry& registry = ProfileRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mtx);
+
+		// ʱ䵥λΪ΢
+		stream << "{\"traceEvents\":[\n" << std::fixed << std::setprecision(3);
+		bool first = true;
+		for (auto buffer : registry.buffers)
+		{
+			buffer->ForEach([&](const ProfileEvent& event) {
+				if (!first) stream << ",\n";
+				first = false;
+				stream << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->thread
+					<< ",\"ts\":" << (event.begin - profile_epoch) / 1e3
+					<< ",\"dur\":" << (event.end - event.begin) / 1e3 << "}";
+			});
+		}
+		stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		CHECK(stream) << "Failed to write " << file;
+	}
+
+	void Profiler::Clear()
+	{
+		ProfileRegistry& registry = ProfileRegistry::Get();
+		std::lock_guard<std::mutex> lock(registry.mtx);
+		for (auto buffer : registry.buffers) buffer->Clear();
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const ProfileStats& stats)
+	{
+		std::ios::fmtflags flags = stream.flags();
+		stream << std::left << std::setw(24) << stats.name << std::right << std::fixed << std::setprecision(3)
+			<< " count: " << std::setw(8) << stats.count
+			<< " total: " << std::setw(10) << stats.total / 1e6 << " ms"
+			<< " mean: " << std::setw(10) << stats.mean / 1e3 << " us"
+			<< " p50: " << std::setw(10) << stats.p50 / 1e3 << " us"
+			<< " p99: " << std::setw(10) << stats.p99 / 1e3 << " us"
+			<< " max: " << std::setw(10) << stats.max / 1e3 << " us";
+		stream.flags(flags);
+		return stream;
+	}
+
+} // namespace chaos
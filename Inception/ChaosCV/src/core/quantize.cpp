@@ -0,0 +1,380 @@
+#include "core\quantize.hpp"
+#include "core\core.hpp"
+#include "core\cpu.hpp"
+#include "core\simd.hpp"
+
+#include <cmath>
+
+namespace chaos
+{
+	static constexpr int quant_max = 127;
+
+#pragma region Load & Store
+	// һδCvt<ISA>::lanesԪأдint8ʱضϵ[-127, 127]
+	template<class ISA>
+	static typename simd::Cvt<ISA>::F Load(const float* ptr) { return simd::Vec<ISA, float>::Load(ptr); }
+	template<class ISA>
+	static typename simd::Cvt<ISA>::F Load(const char* ptr) { return simd::Cvt<ISA>::ToFloat(simd::Cvt<ISA>::LoadI32(ptr)); }
+	template<class ISA>
+	static typename simd::Cvt<ISA>::F Load(const int* ptr) { return simd::Cvt<ISA>::ToFloat(simd::Cvt<ISA>::LoadI32(ptr)); }
+
+	template<class ISA>
+	static void Store(float* ptr, typename simd::Cvt<ISA>::F a) { simd::Vec<ISA, float>::Store(ptr, a); }
+	template<class ISA>
+	static void Store(char* ptr, typename simd::Cvt<ISA>::F a)
+	{
+		using V = simd::Vec<ISA, float>;
+		// maxĵһΪNaNʱصڶ
+		a = V::Min(V::Max(a, V::Set1(-quant_max)), V::Set1(quant_max));
+		simd::Cvt<ISA>::StoreI32(ptr, simd::Cvt<ISA>::ToInt(a));
+	}
+
+	// int8ʱdst = (src + beta) * alphabetaΪ-zero_pointǾȷģࣨint32ۼӽdst = src * alpha + beta
+	template<class ISA, class Src>
+	static typename simd::Cvt<ISA>::F Affine(typename simd::Cvt<ISA>::F x, typename simd::Cvt<ISA>::F alpha, typename simd::Cvt<ISA>::F beta)
+	{
+		using V = simd::Vec<ISA, float>;
+		if constexpr (std::is_same<Src, char>::value) return V::Mul(V::Add(x, beta), alpha);
+		else return V::FMA(x, alpha, beta);
+	}
+
+	static float Affine(float x, float alpha, float beta, const char*) { return (x + beta) * alpha; }
+	template<class Src>
+	static float Affine(float x, float alpha, float beta, const Src*) { return x * alpha + beta; }
+
+	static float Cast(float value, float*) { return value; }
+	static char Cast(float value, char*)
+	{
+		value = std::min((float)quant_max, std::max((float)-quant_max, value));
+		return (char)std::rint(value);
+	}
+#pragma endregion
+
+#pragma region Kernels
+	template<class ISA, class Src, class Dst>
+	static void ScaleRow(const Src* src, Dst* dst, size_t len, float alpha, float beta)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, float>;
+			auto va = V::Set1(alpha), vb = V::Set1(beta);
+			for (; i + V::lanes <= len; i += V::lanes) Store<ISA>(dst + i, Affine<ISA, Src>(Load<ISA>(src + i), va, vb));
+		}
+		for (; i < len; i++) dst[i] = Cast(Affine((float)src[i], alpha, beta, src), dst);
+	}
+
+	// ͨNHWCʱͨalphabetaperiodԪظ
+	template<class ISA, class Src, class Dst>
+	static void ScaleRowInterleaved(const Src* src, Dst* dst, size_t len, const float* alpha, const float* beta, size_t period)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, float>;
+			for (size_t j = 0; i + V::lanes <= len; i += V::lanes, j = (j + V::lanes) % period)
+			{
+				Store<ISA>(dst + i, Affine<ISA, Src>(Load<ISA>(src + i), V::Load(alpha + j), V::Load(beta + j)));
+			}
+		}
+		for (; i < len; i++) dst[i] = Cast(Affine((float)src[i], alpha[i % period], beta[i % period], src), dst);
+	}
+
+	template<class ISA, class Src, class Dst>
+	static void ScaleRows(const Mat& src, Mat& dst, const std::vector<float>& alpha, const std::vector<float>& beta, int axis)
+	{
+		// batchʱÿbatchһݣ
+		if (0 == axis)
+		{
+			for (size_t n = 0; n < src.size[0]; n++)
+			{
+				Mat out = dst.Batch(n, n + 1);
+				ScaleRows<ISA, Src, Dst>(src.Batch(n, n + 1), out, { alpha[n] }, { beta[n] }, -1);
+			}
+			return;
+		}
+
+		bool per_channel = 1 == axis;
+		MatRowIterator it({ &src, &dst }, !per_channel);
+		if (per_channel && it.channel_inner)
+		{
+			size_t period = src.size[1] * 16;
+			std::vector<float> a(period), b(period);
+			for (size_t i = 0; i < period; i++)
+			{
+				a[i] = alpha[i % src.size[1]];
+				b[i] = beta[i % src.size[1]];
+			}
+			for (size_t row = 0; row < it.rows; row++)
+			{
+				ScaleRowInterleaved<ISA>((const Src*)it.Ptr(0, row), (Dst*)it.Ptr(1, row), it.length, a.data(), b.data(), period);
+			}
+			return;
+		}
+
+		for (size_t row = 0; row < it.rows; row++)
+		{
+			size_t c = per_channel ? it.Channel(row) : 0;
+			ScaleRow<ISA>((const Src*)it.Ptr(0, row), (Dst*)it.Ptr(1, row), it.length, alpha[c], beta[c]);
+		}
+	}
+
+	template<class Src, class Dst>
+	static void Scale(const Mat& src, Mat& dst, const std::vector<float>& alpha, const std::vector<float>& beta, int axis)
+	{
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			ScaleRows<simd::AVX512, Src, Dst>(src, dst, alpha, beta, axis); break;
+		case SIMD_AVX2:
+			ScaleRows<simd::AVX2, Src, Dst>(src, dst, alpha, beta, axis); break;
+		case SIMD_SSE2:
+			ScaleRows<simd::SSE2, Src, Dst>(src, dst, alpha, beta, axis); break;
+		default:
+			ScaleRows<simd::Scalar, Src, Dst>(src, dst, alpha, beta, axis); break;
+		}
+	}
+
+	template<class ISA>
+	static void MinMaxRow(const float* src, size_t len, float& lo, float& hi)
+	{
+		size_t i = 0;
+		if constexpr (!std::is_same<ISA, simd::Scalar>::value)
+		{
+			using V = simd::Vec<ISA, float>;
+			if (len >= V::lanes)
+			{
+				auto vlo = V::Load(src), vhi = vlo;
+				for (i = V::lanes; i + V::lanes <= len; i += V::lanes)
+				{
+					auto v = V::Load(src + i);
+					vlo = V::Min(vlo, v);
+					vhi = V::Max(vhi, v);
+				}
+				float l[V::lanes], h[V::lanes];
+				V::Store(l, vlo);
+				V::Store(h, vhi);
+				for (size_t j = 0; j < V::lanes; j++)
+				{
+					lo = std::min(lo, l[j]);
+					hi = std::max(hi, h[j]);
+				}
+			}
+		}
+		for (; i < len; i++)
+		{
+			lo = std::min(lo, src[i]);
+			hi = std::max(hi, src[i]);
+		}
+	}
+
+	// ÿͨaxisΪ-1ʱֻһСֵֵ
+	template<class ISA>
+	static void MinMax(const Mat& src, int axis, std::vector<float>& lo, std::vector<float>& hi)
+	{
+		if (0 == axis)
+		{
+			for (size_t n = 0; n < src.size[0]; n++)
+			{
+				std::vector<float> l(1, lo[n]), h(1, hi[n]);
+				MinMax<ISA>(src.Batch(n, n + 1), -1, l, h);
+				lo[n] = l[0];
+				hi[n] = h[0];
+			}
+			return;
+		}
+
+		bool per_channel = 1 == axis;
+		MatRowIterator it({ &src }, !per_channel);
+		for (size_t row = 0; row < it.rows; row++)
+		{
+			const float* ptr = (const float*)it.Ptr(0, row);
+			if (per_channel && it.channel_inner)
+			{
+				size_t chs = src.size[1];
+				for (size_t i = 0; i < it.length; i++)
+				{
+					lo[i % chs] = std::min(lo[i % chs], ptr[i]);
+					hi[i % chs] = std::max(hi[i % chs], ptr[i]);
+				}
+				continue;
+			}
+
+			size_t c = per_channel ? it.Channel(row) : 0;
+			MinMaxRow<ISA>(ptr, it.length, lo[c], hi[c]);
+		}
+	}
+#pragma endregion
+
+	static void CheckParam(const QuantParam& param, const MatSize& size)
+	{
+		CHECK(-1 <= param.axis && param.axis <= 1) << "Quantization axis must be -1, 0 or 1.";
+		size_t n = param.PerChannel() ? size[param.axis] : 1;
+		CHECK(param.scale.size() == n && param.zero_point.size() == n)
+			<< "Quantization parameters must have " << n << " elements, got " << param << ".";
+		for (size_t c = 0; c < n; c++)
+		{
+			CHECK(param.scale[c] > 0 && std::isfinite(param.scale[c])) << "Scale of channel " << c << " must be positive.";
+			CHECK(-quant_max <= param.zero_point[c] && param.zero_point[c] <= quant_max)
+				<< "Zero point of channel " << c << " must be in [-127, 127].";
+		}
+	}
+
+	bool QuantParam::IsSymmetric() const
+	{
+		for (int zp : zero_point)
+		{
+			if (0 != zp) return false;
+		}
+		return true;
+	}
+
+	QuantParam QuantParam::FromRange(float min, float max)
+	{
+		// 0ܾȷʾReLU֮0û
+		min = std::min(min, 0.f);
+		max = std::max(max, 0.f);
+		if (max == min) return QuantParam(1.f, 0);
+
+		float scale = (max - min) / (2 * quant_max);
+		int zero_point = (int)std::rint(-quant_max - min / scale);
+		return QuantParam(scale, std::min(quant_max, std::max(-quant_max, zero_point)));
+	}
+
+	QuantParam QuantParam::Calibrate(const Mat& src, int axis, bool symmetric)
+	{
+		CHECK(nullptr != src.data_start) << "Empty input.";
+		CHECK_EQ(src.depth, DEPTH_32F) << "Calibrate only supports DEPTH_32F.";
+		CHECK(-1 <= axis && axis <= 1) << "Quantization axis must be -1, 0 or 1.";
+
+		size_t n = axis >= 0 ? src.size[axis] : 1;
+		std::vector<float> lo(n, INFINITY), hi(n, -INFINITY);
+		switch (GetSimdLevel())
+		{
+		case SIMD_AVX512:
+			MinMax<simd::AVX512>(src, axis, lo, hi); break;
+		case SIMD_AVX2:
+			MinMax<simd::AVX2>(src, axis, lo, hi); break;
+		case SIMD_SSE2:
+			MinMax<simd::SSE2>(src, axis, lo, hi); break;
+		default:
+			MinMax<simd::Scalar>(src, axis, lo, hi); break;
+		}
+
+		QuantParam param;
+		param.axis = axis;
+		for (size_t c = 0; c < n; c++)
+		{
+			if (symmetric)
+			{
+				float bound = std::max(std::fabs(lo[c]), std::fabs(hi[c]));
+				param.scale.push_back(bound > 0 ? bound / quant_max : 1.f);
+				param.zero_point.push_back(0);
+			}
+			else
+			{
+				QuantParam range = FromRange(lo[c], hi[c]);
+				param.scale.push_back(range.scale[0]);
+				param.zero_point.push_back(range.zero_point[0]);
+			}
+		}
+		return param;
+	}
+
+	std::ostream& operator<<(std::ostream& stream, const QuantParam& param)
+	{
+		stream << "[";
+		if (param.PerChannel()) stream << "axis: " << param.axis << ", ";
+		stream << "scale: {";
+		for (size_t c = 0; c < param.scale.size(); c++) stream << (c ? ", " : "") << param.scale[c];
+		stream << "}, zero_point: {";
+		for (size_t c = 0; c < param.zero_point.size(); c++) stream << (c ? ", " : "") << param.zero_point[c];
+		stream << "}]";
+		return stream;
+	}
+
+	QMat::QMat(const MatSize& size, const QuantParam& param, MatLayout layout) : param(param)
+	{
+		Create(size, DEPTH_8S, true, layout);
+	}
+
+	QMat::QMat(const Mat& mtx, const QuantParam& param) : Mat(mtx), param(param)
+	{
+		CHECK_EQ(depth, DEPTH_8S) << "QMat must be DEPTH_8S.";
+	}
+
+	void Quantize(const Mat& src, QMat& dst, const QuantParam& param)
+	{
+		CHAOS_PROFILE_SCOPE("Quantize");
+		CHECK(nullptr != src.data_start) << "Empty input.";
+		CHECK_EQ(src.depth, DEPTH_32F) << "Quantize only supports DEPTH_32F.";
+		CheckParam(param, src.size);
+
+		if (&src == &dst)
+		{
+			QMat tmp;
+			Quantize(src, tmp, param);
+			dst = std::move(tmp);
+			return;
+		}
+
+		dst.Create(src.size, DEPTH_8S, false, src.layout);
+		dst.param = param;
+
+		std::vector<float> alpha, beta;
+		for (size_t c = 0; c < param.scale.size(); c++)
+		{
+			alpha.push_back(1.f / param.scale[c]);
+			beta.push_back((float)param.zero_point[c]);
+		}
+		Scale<float, char>(src, dst, alpha, beta, param.axis);
+	}
+
+	void Dequantize(const QMat& src, Mat& dst)
+	{
+		CHAOS_PROFILE_SCOPE("Dequantize");
+		CHECK(nullptr != src.data_start) << "Empty input.";
+		CHECK_EQ(src.depth, DEPTH_8S) << "Dequantize only supports DEPTH_8S.";
+		CheckParam(src.param, src.size);
+
+		if (&src == &dst)
+		{
+			Mat tmp;
+			Dequantize(src, tmp);
+			dst = std::move(tmp);
+			return;
+		}
+
+		dst.Create(src.size, DEPTH_32F, false, src.layout);
+
+		std::vector<float> alpha, beta;
+		for (size_t c = 0; c < src.param.scale.size(); c++)
+		{
+			alpha.push_back(src.param.scale[c]);
+			beta.push_back((float)-src.param.zero_point[c]);
+		}
+		Scale<char, float>(src, dst, alpha, beta, src.param.axis);
+	}
+
+	void Dequantize(const Mat& src, Mat& dst, const std::vector<float>& scale, const std::vector<float>& shift, int axis)
+	{
+		CHAOS_PROFILE_SCOPE("Dequantize");
+		CHECK(nullptr != src.data_start) << "Empty input.";
+		CHECK_EQ(src.depth, DEPTH_32S) << "Dequantize only supports DEPTH_32S accumulators.";
+		CHECK(-1 <= axis && axis <= 1) << "Quantization axis must be -1, 0 or 1.";
+		size_t n = axis >= 0 ? src.size[axis] : 1;
+		CHECK(scale.size() == n && shift.size() == n) << "Scale and shift must have " << n << " elements.";
+
+		if (&src == &dst)
+		{
+			Mat tmp;
+			Dequantize(src, tmp, scale, shift, axis);
+			dst = std::move(tmp);
+			return;
+		}
+
+		dst.Create(src.size, DEPTH_32F, false, src.layout);
+		Scale<int, float>(src, dst, scale, shift, axis);
+	}
+
+} // namespace chaos
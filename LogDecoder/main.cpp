@@ -0,0 +1,30 @@
+#include "chaoscv.hpp"
+
+#include <fstream>
+
+// BinaryLogдĶ־תΪı
+// LogDecoder <input> [output]ûָoutputʱ׼
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: LogDecoder <input> [output]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	CHECK(in.is_open()) << "Can not open " << argv[1];
+
+	if (argc > 2)
+	{
+		std::ofstream out(argv[2]);
+		CHECK(out.is_open()) << "Can not open " << argv[2];
+		chaos::DecodeBinaryLog(in, out);
+	}
+	else
+	{
+		chaos::DecodeBinaryLog(in, std::cout);
+	}
+
+	return 0;
+}